@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <RTTI.h>
+
+using namespace std::string_literals;
+
+class BenchBase : public rtti::Object
+{
+    TYPE_DECLARE(rtti::Object)
+
+public:
+    static void RegisterRTTI()
+    {
+        rtti::TypeRegister<BenchBase>::New();
+    }
+};
+
+class BenchObject : public BenchBase
+{
+    TYPE_DECLARE(BenchBase)
+
+public:
+    static void RegisterRTTI()
+    {
+        rtti::TypeRegister<BenchObject>::New()
+            .constructor<>()
+            .method("Add"s, &BenchObject::Add);
+    }
+
+    int Add(int a, int b)
+    {
+        return Value += a + b;
+    }
+
+    int Value = 0;
+};
+
+// 防止被测代码被优化掉
+static volatile size_t sink = 0;
+
+template <typename F>
+static void Run(const char* name, F f, size_t iterations = 5'000'000)
+{
+    for (size_t i = 0; i < iterations / 10; i++)
+        f(i);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+        f(i);
+    auto end = std::chrono::steady_clock::now();
+
+    auto ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    printf("%-40s %8.2f ns/op\n", name, ns);
+}
+
+int main()
+{
+    // 单线程进程中 libstdc++ 的 shared_ptr 不使用原子操作，先创建一个线程以模拟多线程程序
+    std::thread([] {}).join();
+
+    rtti::InitCoreType();
+    BenchBase::RegisterRTTI();
+    BenchObject::RegisterRTTI();
+
+#if defined(RTTI_OBJECT_TYPE_CACHE)
+    printf("[RTTI_OBJECT_TYPE_CACHE]\n");
+#endif
+#if defined(RTTI_INTRUSIVE_PTR_UNSYNCHRONIZED)
+    printf("[RTTI_INTRUSIVE_PTR_UNSYNCHRONIZED]\n");
+#elif defined(RTTI_INTRUSIVE_PTR)
+    printf("[RTTI_INTRUSIVE_PTR]\n");
+#endif
+
+    rtti::ObjectPtr intBox = rtti::Box(12345);
+    rtti::ObjectPtr stringBox = rtti::Box("payload"s);
+    rtti::ObjectPtr object = rtti::MakePtr<BenchObject>();
+    auto add = rtti::type_of<BenchObject>()->GetMethod("Add"s);
+
+    Run("ObjectPtr copy", [&](size_t) { rtti::ObjectPtr copy = object; sink = sink + (copy != nullptr); });
+    Run("MakePtr<BenchObject>", [&](size_t) { sink = sink + (rtti::MakePtr<BenchObject>() != nullptr); });
+    Run("CreateInstance()", [&](size_t) { sink = sink + (rtti::type_of<BenchObject>()->CreateInstance({}) != nullptr); });
+    Run("Unbox<int>", [&](size_t) { sink = sink + rtti::Unbox<int>(intBox); });
+    Run("Unbox<const std::string&>", [&](size_t) { sink = sink + rtti::Unbox<const std::string&>(stringBox).size(); });
+    Run("cast<int>(ObjectPtr)", [&](size_t) { sink = sink + rtti::cast<int>(intBox); });
+    Run("cast<Ptr<BenchBase>>(ObjectPtr)", [&](size_t) { sink = sink + (rtti::cast<rtti::Ptr<BenchBase>>(object) != nullptr); });
+    Run("IsAssignableFrom(ObjectPtr)", [&](size_t) { sink = sink + rtti::type_of<BenchBase>()->IsAssignableFrom(object); });
+    Run("Box(int)", [&](size_t i) { sink = sink + (rtti::Box((int)i) != nullptr); });
+    Run("Invoke(obj, {Box, Box})", [&](size_t i) { sink = sink + (add->Invoke(object, {rtti::Box((int)i), rtti::Box(1)}) != nullptr); });
+    Run("Invoke(obj, int, int)", [&](size_t i) { sink = sink + (add->Invoke(object, (int)i, 1) != nullptr); });
+
+    auto invoker = add->TryGetInvoker<int(BenchObject&, int, int)>();
+    auto& target = *rtti::cast<rtti::Ptr<BenchObject>>(object);
+    Run("TryGetInvoker<int(Self&, int, int)>", [&](size_t i) { sink = sink + invoker(target, (int)i, 1); });
+
+    std::vector<rtti::ObjectPtr> targets;
+    for (int i = 0; i < 100; i++)
+        targets.push_back(rtti::MakePtr<BenchObject>());
+    Run("100 x Invoke(obj, int, int)", [&](size_t i) { for (auto& t : targets) sink = sink + (add->Invoke(t, (int)i, 1) != nullptr); }, 50'000);
+    Run("InvokeBatch(100 targets, int, int)", [&](size_t i) { sink = sink + add->InvokeBatch(targets, (int)i, 1); }, 50'000);
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+namespace rtti
+{
+// 元数据分配区：按块顺序分配（bump），不单独释放，Clear() 时整体释放
+// 每个模块（插件）可以使用独立的 arena，卸载时通过 Type::Release() 一次释放
+class Arena
+{
+public:
+    explicit Arena(size_t blockSize = 16 * 1024)
+        : m_blockSize(blockSize)
+    {
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena()
+    {
+        Clear();
+    }
+
+    void* Allocate(size_t size, size_t alignment)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_blocks.empty())
+        {
+            auto& block = m_blocks.back();
+            size_t offset = AlignedOffset(block, alignment);
+            if (offset + size <= block.size)
+            {
+                block.used = offset + size;
+                return block.data.get() + offset;
+            }
+        }
+
+        // new[] 只保证基本对齐，超出的对齐要求在块内补齐
+        size_t blockSize = std::max(m_blockSize, size + alignment);
+        auto& block = m_blocks.emplace_back(Block{std::make_unique<std::byte[]>(blockSize), blockSize, 0});
+        size_t offset = AlignedOffset(block, alignment);
+        block.used = offset + size;
+        return block.data.get() + offset;
+    }
+
+    // 在 arena 中构造对象，Clear() 时按构造的逆序析构
+    template <typename T, typename... Args>
+    T* New(Args&&... args)
+    {
+        T* object = ::new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_destructors.push_back({object, [](void* p) { static_cast<T*>(p)->~T(); }});
+        }
+        return object;
+    }
+
+    // ptr 是否由当前 arena 分配
+    bool Owns(const void* ptr) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& block : m_blocks)
+        {
+            if (ptr >= block.data.get() && ptr < block.data.get() + block.size)
+                return true;
+        }
+        return false;
+    }
+
+    // 析构全部对象并释放内存，调用前须保证没有其他代码再访问这些对象
+    void Clear()
+    {
+        std::vector<Destructor> destructors;
+        std::vector<Block> blocks;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            destructors.swap(m_destructors);
+            blocks.swap(m_blocks);
+        }
+
+        for (auto it = destructors.rbegin(); it != destructors.rend(); ++it)
+            it->destroy(it->object);
+    }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+        size_t used;
+    };
+
+    // 按绝对地址对齐，块起始地址不一定满足 alignment
+    static size_t AlignedOffset(const Block& block, size_t alignment)
+    {
+        auto base = reinterpret_cast<uintptr_t>(block.data.get());
+        return ((base + block.used + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+    }
+
+    struct Destructor
+    {
+        void* object;
+        void (*destroy)(void* object);
+    };
+
+    size_t m_blockSize;
+    mutable std::mutex m_mutex;
+    std::vector<Block> m_blocks;
+    std::vector<Destructor> m_destructors;
+};
+
+// 未指定 arena 时使用的全局 arena，由 Shutdown() 释放
+inline Arena& GetDefaultArena()
+{
+    static Arena* arena = new Arena();
+    return *arena;
+}
+
+inline Arena*& GetCurrentArenaSlot()
+{
+    thread_local Arena* arena = nullptr;
+    return arena;
+}
+
+// 当前线程注册元数据时使用的 arena
+inline Arena& GetCurrentArena()
+{
+    auto arena = GetCurrentArenaSlot();
+    return arena != nullptr ? *arena : GetDefaultArena();
+}
+
+// 作用域内当前线程新建的类型和注册的成员都分配在 arena 中
+// 作用域内首次调用 type_of<T>() 创建的类型同样属于该 arena，核心类型应在进入作用域前创建（如 InitCoreType()）
+class ArenaScope
+{
+public:
+    explicit ArenaScope(Arena& arena)
+        : m_previous(std::exchange(GetCurrentArenaSlot(), &arena))
+    {
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    ~ArenaScope()
+    {
+        GetCurrentArenaSlot() = m_previous;
+    }
+
+private:
+    Arena* m_previous;
+};
+} // namespace rtti
@@ -1,45 +1,87 @@
 ﻿#pragma once
 #include "System.h"
+#include "Concurrent.h"
 #include <any>
 #include <map>
+#include <span>
+#include <algorithm>
 
 namespace rtti
 {
+// 特性，按 Id 升序存放在连续数组中
+struct Attribute
+{
+    size_t Id;
+    std::any Value;
+};
+
 class Attributable
 {
 protected:
-    std::map<size_t, std::any> m_attributes;
+    // 空表不分配，替换时整体发布新表，旧表保留给仍持有引用的读者
+    Published<const std::vector<Attribute>> m_attributes;
 
 protected:
     Attributable(const std::map<size_t, std::any>& attributes)
-        : m_attributes(attributes)
     {
+        SetAttributes(attributes);
+    }
+
+    void SetAttributes(const std::map<size_t, std::any>& attributes)
+    {
+        if (attributes.empty() && m_attributes.Load() == nullptr)
+            return;
+
+        // std::map 已按 id 排序
+        auto table = new std::vector<Attribute>();
+        table->reserve(attributes.size());
+        for (auto& [id, value] : attributes)
+            table->push_back({id, value});
+        m_attributes.Publish(table);
+    }
+
+    const Attribute* FindAttributeEntry(size_t id) const
+    {
+        auto attributes = GetAttributes();
+        auto it = std::lower_bound(attributes.begin(), attributes.end(), id, [](const Attribute& a, size_t v) { return a.Id < v; });
+        return it != attributes.end() && it->Id == id ? &*it : nullptr;
     }
 
 public:
+    // 全部特性，按 Id 升序
+    std::span<const Attribute> GetAttributes() const
+    {
+        auto attributes = m_attributes.Load();
+        return attributes != nullptr ? std::span<const Attribute>(*attributes) : std::span<const Attribute>();
+    }
+
     bool HasAttribute(size_t id) const
     {
-        return m_attributes.find(id) != m_attributes.end();
+        return FindAttributeEntry(id) != nullptr;
     }
 
-    std::any GetAttribute(size_t id) const
+    // 不存在时返回空的 std::any
+    const std::any& GetAttribute(size_t id) const
     {
-        auto it = m_attributes.find(id);
-        if (it != m_attributes.end())
-        {
-            return it->second;
-        }
+        static const std::any empty;
+        auto attribute = FindAttributeEntry(id);
+        return attribute != nullptr ? attribute->Value : empty;
+    }
 
-        return std::any();
+    // 指向存储的值，不存在或类型不是 T 时返回 nullptr
+    template <typename T>
+    const T* FindAttribute(size_t id) const
+    {
+        auto attribute = FindAttributeEntry(id);
+        return attribute != nullptr ? std::any_cast<T>(&attribute->Value) : nullptr;
     }
 
     template <typename T>
     T GetAttribute(size_t id, T defaultValue = {}) const
     {
-        auto v = GetAttribute(id);
-        T* pV = std::any_cast<T>(&v);
-        if (pV != nullptr)
-            return *pV;
+        auto value = FindAttribute<T>(id);
+        if (value != nullptr)
+            return *value;
 
         return defaultValue;
     }
@@ -0,0 +1,403 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace rtti
+{
+// 注册表写锁，所有注册操作在锁内串行执行，查询不加锁
+// 持有此锁时不要调用 type_of<T>()，否则可能与其内部静态变量的初始化互相等待
+inline std::recursive_mutex& GetRegistryMutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+// 被替换下来的快照分两类回收：
+// 调用方可能长期持有其中引用的快照（名称、成员索引等）只在静止点由 ReclaimRetired() 释放；
+// 只在库内部 ReadGuard 作用域中访问的快照（名称索引、转换 / 比较规则、构造函数缓存）按纪元回收，
+// 替换前已进入的读者全部离开后，下一次替换时即被释放
+
+// 被替换下来的快照可能仍有读者在访问，先挂到无锁链表上，到没有读者的时刻再统一释放
+struct RetiredNode
+{
+    const void* ptr;
+    void (*deleter)(const void*);
+    RetiredNode* next;
+};
+
+inline std::atomic<RetiredNode*>& GetRetiredList()
+{
+    static std::atomic<RetiredNode*> head = nullptr;
+    return head;
+}
+
+// 读者线程也会调用，不加锁
+template <typename T>
+inline void Retire(const T* ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    auto node = new RetiredNode{ptr, [](const void* p) { delete static_cast<const T*>(p); }, nullptr};
+    auto& head = GetRetiredList();
+    node->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+// 每个线程占用一个读者槽，记录其进入 ReadGuard 时的纪元，0 表示不在读取
+struct ReaderSlot
+{
+    std::atomic<uint64_t> epoch = 0;
+    std::atomic<bool> used = false;
+    ReaderSlot* next = nullptr;
+};
+
+inline std::atomic<uint64_t>& GetGlobalEpoch()
+{
+    static std::atomic<uint64_t> epoch = 1;
+    return epoch;
+}
+
+// 槽只追加不释放，线程退出后由新线程复用
+inline std::atomic<ReaderSlot*>& GetReaderSlots()
+{
+    static std::atomic<ReaderSlot*> head = nullptr;
+    return head;
+}
+
+struct ThreadReader
+{
+    ThreadReader()
+    {
+        auto& head = GetReaderSlots();
+        for (auto cur = head.load(std::memory_order_acquire); cur != nullptr; cur = cur->next)
+        {
+            bool expected = false;
+            if (!cur->used.load(std::memory_order_relaxed) && cur->used.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                slot = cur;
+                return;
+            }
+        }
+
+        slot = new ReaderSlot();
+        slot->used.store(true, std::memory_order_relaxed);
+        slot->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    ~ThreadReader()
+    {
+        slot->used.store(false, std::memory_order_release);
+    }
+
+    ReaderSlot* slot;
+    uint32_t depth = 0;
+};
+
+inline ThreadReader& GetThreadReader()
+{
+    thread_local ThreadReader reader;
+    return reader;
+}
+
+// 读取按纪元回收的快照前进入，作用域内取得的快照指针保持有效，可以嵌套
+class ReadGuard
+{
+public:
+    ReadGuard()
+        : m_reader(GetThreadReader())
+    {
+        // 写入槽、读取快照指针、替换快照指针、回收方读取槽都是 seq_cst 操作：
+        // 要么回收方看到本槽的纪元，要么本线程读到已替换的新快照
+        if (m_reader.depth++ == 0)
+            m_reader.slot->epoch.store(GetGlobalEpoch().load(std::memory_order_acquire), std::memory_order_seq_cst);
+    }
+
+    ~ReadGuard()
+    {
+        if (--m_reader.depth == 0)
+            m_reader.slot->epoch.store(0, std::memory_order_release);
+    }
+
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+
+private:
+    ThreadReader& m_reader;
+};
+
+// 按纪元回收的旧快照，只在持有注册表写锁时访问
+struct EpochRetired
+{
+    const void* ptr;
+    void (*deleter)(const void*);
+    uint64_t epoch; // 替换时的纪元
+};
+
+inline std::vector<EpochRetired>& GetEpochRetiredList()
+{
+    static auto retired = new std::vector<EpochRetired>();
+    return *retired;
+}
+
+// 需持有注册表写锁；释放替换早于全部活跃读者进入的旧快照，all 为 true 时全部释放（静止点）
+inline void ReclaimEpochRetired(bool all = false)
+{
+    uint64_t oldest = UINT64_MAX;
+    if (!all)
+    {
+        for (auto slot = GetReaderSlots().load(std::memory_order_acquire); slot != nullptr; slot = slot->next)
+        {
+            auto epoch = slot->epoch.load(std::memory_order_seq_cst);
+            if (epoch != 0)
+                oldest = std::min(oldest, epoch);
+        }
+    }
+
+    auto& retired = GetEpochRetiredList();
+    size_t kept = 0;
+    for (auto& item : retired)
+    {
+        if (all || item.epoch < oldest)
+            item.deleter(item.ptr);
+        else
+            retired[kept++] = item;
+    }
+    retired.resize(kept);
+}
+
+// 需持有注册表写锁，快照只能在 ReadGuard 作用域内读取
+template <typename T>
+inline void RetireByEpoch(const T* ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    auto epoch = GetGlobalEpoch().fetch_add(1, std::memory_order_acq_rel);
+    GetEpochRetiredList().push_back({ptr, [](const void* p) { delete static_cast<const T*>(p); }, epoch});
+    ReclaimEpochRetired();
+}
+
+// 释放全部旧快照，调用时须保证没有其他线程正在进行反射查询
+// Type::Release() 和 Shutdown() 会调用；长期运行的进程可以在加载完一批模块等时刻自行调用，
+// 以释放改名、注册成员等替换下来的名称和成员索引
+inline void ReclaimRetired()
+{
+    auto node = GetRetiredList().exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr)
+    {
+        auto next = node->next;
+        node->deleter(node->ptr);
+        delete node;
+        node = next;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+    ReclaimEpochRetired(true);
+}
+
+// 以原子指针发布的快照，发布后内容不再修改（除非 T 自身的成员是原子的）
+template <typename T>
+class Published
+{
+public:
+    Published() = default;
+    Published(const Published&) = delete;
+    Published& operator=(const Published&) = delete;
+
+    ~Published()
+    {
+        delete m_ptr.load(std::memory_order_relaxed);
+    }
+
+    // seq_cst 以配合 ReadGuard 的纪元回收
+    T* Load() const
+    {
+        return m_ptr.load(std::memory_order_seq_cst);
+    }
+
+    // 替换下来的旧快照交给 Retire，保留到下一个静止点，期间每次替换都占用一份旧快照的内存
+    // 只应用于变化少的数据，或调用方会长期持有其中引用的数据
+    void Publish(T* value)
+    {
+        Retire(m_ptr.exchange(value, std::memory_order_acq_rel));
+    }
+
+    // 需持有注册表写锁，读者只能在 ReadGuard 作用域内访问；旧快照在读者离开后即可释放
+    void PublishByEpoch(T* value)
+    {
+        RetireByEpoch(m_ptr.exchange(value, std::memory_order_seq_cst));
+    }
+
+private:
+    std::atomic<T*> m_ptr = nullptr;
+};
+
+// 只追加的数组，写入方需持有注册表写锁，读取无锁
+// 扩容时旧存储块不释放，已取得的 span 始终有效
+template <typename T>
+class ConcurrentArray
+{
+public:
+    ConcurrentArray() = default;
+    ConcurrentArray(const ConcurrentArray&) = delete;
+    ConcurrentArray& operator=(const ConcurrentArray&) = delete;
+
+    std::span<const T> Get() const
+    {
+        // 先读长度再读存储块：扩容时新存储块先于长度发布，读到的存储块容量不小于该长度
+        auto size = m_size.load(std::memory_order_acquire);
+        auto block = m_block.load(std::memory_order_acquire);
+        if (block == nullptr)
+            return {};
+        return std::span<const T>(block->items.get(), size);
+    }
+
+    size_t size() const
+    {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+    void Add(const T& value)
+    {
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+
+        auto block = m_block.load(std::memory_order_relaxed);
+        auto size = m_size.load(std::memory_order_relaxed);
+        if (block == nullptr || size == block->capacity)
+        {
+            auto newBlock = new Block(std::max<size_t>(size * 2, 4));
+            if (block != nullptr)
+                std::copy(block->items.get(), block->items.get() + size, newBlock->items.get());
+            newBlock->previous.reset(block);
+            m_block.store(newBlock, std::memory_order_release);
+            block = newBlock;
+        }
+
+        // 先写入元素再发布长度，读者看到的长度内的元素都已写完
+        block->items[size] = value;
+        m_size.store(size + 1, std::memory_order_release);
+    }
+
+    // 覆盖或移除已发布的元素，调用时须保证没有并发的读者
+    void Set(size_t index, const T& value)
+    {
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+        m_block.load(std::memory_order_relaxed)->items[index] = value;
+    }
+
+    template <typename Pred>
+    void RemoveIf(Pred pred)
+    {
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+
+        auto block = m_block.load(std::memory_order_relaxed);
+        if (block == nullptr)
+            return;
+
+        auto items = block->items.get();
+        auto end = std::remove_if(items, items + m_size.load(std::memory_order_relaxed), pred);
+        m_size.store(end - items, std::memory_order_release);
+    }
+
+    ~ConcurrentArray()
+    {
+        delete m_block.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Block
+    {
+        explicit Block(size_t capacity)
+            : capacity(capacity)
+            , items(std::make_unique<T[]>(capacity))
+        {
+        }
+
+        size_t capacity;
+        std::unique_ptr<T[]> items;
+        std::unique_ptr<Block> previous; // 扩容前的存储块，可能仍有读者在访问
+    };
+
+    std::atomic<Block*> m_block = nullptr;
+    std::atomic<size_t> m_size = 0;
+};
+
+// 按类型编号索引的缓存，读写均无锁（扩容时加注册表写锁）
+// T 须能无锁原子访问，值初始化的 T 表示未缓存；version 变化时整体作废，旧存储块按纪元回收
+template <typename T>
+class IdCache
+{
+public:
+    T Get(size_t index, size_t version) const
+    {
+        ReadGuard guard;
+        auto block = m_block.Load();
+        if (block == nullptr || block->version != version || index >= block->size)
+            return T{};
+        return block->items[index].load(std::memory_order_acquire);
+    }
+
+    void Set(size_t index, size_t version, T value, size_t size)
+    {
+        ReadGuard guard;
+        auto block = m_block.Load();
+        if (!Fits(block, index, version))
+        {
+            std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+            block = m_block.Load();
+            if (block != nullptr && block->version > version)
+                return; // 已有更新的缓存，丢弃基于旧版本计算的结果
+
+            if (!Fits(block, index, version))
+            {
+                // 同一版本内按倍数扩容，新类型不断注册时旧存储块的总量与最终大小同阶
+                bool sameVersion = block != nullptr && block->version == version;
+                auto newBlock = new Block(version, std::max({size, index + 1, sameVersion ? block->size * 2 : 0}));
+                if (sameVersion)
+                {
+                    for (size_t i = 0; i < block->size; i++)
+                        newBlock->items[i].store(block->items[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }
+                m_block.PublishByEpoch(newBlock);
+                block = newBlock;
+            }
+        }
+
+        // 与扩容并发时写入可能落在旧存储块上而丢失，之后重新计算即可
+        block->items[index].store(value, std::memory_order_release);
+    }
+
+private:
+    struct Block
+    {
+        Block(size_t version, size_t size)
+            : version(version)
+            , size(size)
+            , items(std::make_unique<std::atomic<T>[]>(size))
+        {
+        }
+
+        size_t version;
+        size_t size;
+        std::unique_ptr<std::atomic<T>[]> items;
+    };
+
+    static bool Fits(const Block* block, size_t index, size_t version)
+    {
+        return block != nullptr && block->version == version && index < block->size;
+    }
+
+    Published<Block> m_block;
+};
+} // namespace rtti
@@ -1,5 +1,22 @@
 #pragma once
 
+// 定义 RTTI_INTRUSIVE_PTR 后 Ptr<T> 使用内置的侵入式引用计数指针（IntrusivePtr.h），引用计数嵌入 Object 中
+// 再定义 RTTI_INTRUSIVE_PTR_UNSYNCHRONIZED 时计数不使用原子操作，对象只能在单个线程中使用
+#if defined(RTTI_INTRUSIVE_PTR) && !defined(RTTI_PTR)
+#ifndef RTTI_OBJECT_DEFINE
+#define RTTI_OBJECT_DEFINE class Object : public rtti::RefCounted
+#endif
+#define RTTI_PTR(T) rtti::IntrusivePtr<T>
+#define RTTI_MAKE_PTR(T, ...) rtti::MakeIntrusive<T>(__VA_ARGS__)
+#define RTTI_PTR_CAST(T, p) rtti::StaticPointerCast<T>(p)
+#define RTTI_PTR_FROM_RAW(p) rtti::IntrusivePtr<rtti::Object>(p)
+#define RTTI_RAW_FROM_PTR(p) p.get()
+#endif
+
+#if defined(RTTI_INTRUSIVE_PTR_UNSYNCHRONIZED) && defined(RTTI_BOX_CACHE)
+#error "RTTI_BOX_CACHE shares boxes between threads and cannot be used with RTTI_INTRUSIVE_PTR_UNSYNCHRONIZED"
+#endif
+
 // 自定义 Object 基类
 #ifndef RTTI_OBJECT_DEFINE
 #define RTTI_OBJECT_DEFINE class Object : public std::enable_shared_from_this<Object>
@@ -12,7 +29,32 @@
 #define RTTI_PTR_CAST(T, p) std::static_pointer_cast<T>(p)
 #define RTTI_PTR_FROM_RAW(p) p->shared_from_this()
 #define RTTI_RAW_FROM_PTR(p) p.get()
+
+// 定义 RTTI_BOX_POOL 后，装箱对象从线程本地的对象池分配（见 Pool.h），池中的内存不会归还给系统
+#if !defined(RTTI_MAKE_BOX) && defined(RTTI_BOX_POOL)
+#define RTTI_MAKE_BOX(T, ...) std::allocate_shared<T>(rtti::PoolAllocator<T>(), __VA_ARGS__)
 #endif
+#endif
+
+// 创建装箱对象 Boxed<T>
+#ifndef RTTI_MAKE_BOX
+#define RTTI_MAKE_BOX(T, ...) RTTI_MAKE_PTR(T, __VA_ARGS__)
+#endif
+
+// 定义 RTTI_BOX_CACHE 后，bool、小整数和已注册的枚举值装箱时复用共享的只读对象，不再分配内存
+// 共享对象不能通过 Unbox<T&> / Unbox<T*> 修改，需要修改时应自行构造 Boxed<T>
+#if defined(RTTI_BOX_CACHE)
+#ifndef RTTI_BOX_CACHE_MIN
+#define RTTI_BOX_CACHE_MIN -128
+#endif
+#ifndef RTTI_BOX_CACHE_MAX
+#define RTTI_BOX_CACHE_MAX 1023
+#endif
+#endif
+
+// 定义 RTTI_OBJECT_TYPE_CACHE 后，Object 中缓存 GetRttiType() 的结果，Object::GetType() 只读取一个指针
+// 未定义时 GetType() 调用 GetRttiType()；装箱对象总是保存自己的类型，定义后与 Object 共用同一个指针
+// #define RTTI_OBJECT_TYPE_CACHE
 
 #define RTTI_LOG(x, msg) printf("[" #x "]: %s\n\t\t in %s[%s:%d]\n", (msg), __PRETTY_FUNCTION__, __FILE__, __LINE__)
 
@@ -0,0 +1,175 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+namespace rtti
+{
+// 引用计数嵌入对象中的基类，定义 RTTI_INTRUSIVE_PTR 后作为 Object 的基类
+// 定义 RTTI_INTRUSIVE_PTR_UNSYNCHRONIZED 后计数不使用原子操作，对象及其指针只能在单个线程中使用
+class RefCounted
+{
+public:
+    RefCounted(const RefCounted&) = delete;
+    RefCounted& operator=(const RefCounted&) = delete;
+
+    void AddRef() const
+    {
+#if defined(RTTI_INTRUSIVE_PTR_UNSYNCHRONIZED)
+        ++m_refCount;
+#else
+        m_refCount.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    void Release() const
+    {
+#if defined(RTTI_INTRUSIVE_PTR_UNSYNCHRONIZED)
+        if (--m_refCount == 0)
+            delete this;
+#else
+        if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+#endif
+    }
+
+    uint32_t GetRefCount() const
+    {
+#if defined(RTTI_INTRUSIVE_PTR_UNSYNCHRONIZED)
+        return m_refCount;
+#else
+        return m_refCount.load(std::memory_order_relaxed);
+#endif
+    }
+
+protected:
+    RefCounted() = default;
+    virtual ~RefCounted() = default;
+
+private:
+#if defined(RTTI_INTRUSIVE_PTR_UNSYNCHRONIZED)
+    mutable uint32_t m_refCount = 0;
+#else
+    mutable std::atomic<uint32_t> m_refCount = 0;
+#endif
+};
+
+// 指向 RefCounted 子类的智能指针，与原始指针大小相同，可以由原始指针重新构造
+template <typename T>
+class IntrusivePtr
+{
+public:
+    using element_type = T;
+
+    IntrusivePtr() = default;
+
+    IntrusivePtr(std::nullptr_t)
+    {
+    }
+
+    IntrusivePtr(T* ptr)
+        : m_ptr(ptr)
+    {
+        if (m_ptr != nullptr)
+            m_ptr->AddRef();
+    }
+
+    IntrusivePtr(const IntrusivePtr& other)
+        : IntrusivePtr(other.m_ptr)
+    {
+    }
+
+    IntrusivePtr(IntrusivePtr&& other) noexcept
+        : m_ptr(std::exchange(other.m_ptr, nullptr))
+    {
+    }
+
+    template <typename U>
+        requires std::is_convertible_v<U*, T*>
+    IntrusivePtr(const IntrusivePtr<U>& other)
+        : IntrusivePtr(other.get())
+    {
+    }
+
+    template <typename U>
+        requires std::is_convertible_v<U*, T*>
+    IntrusivePtr(IntrusivePtr<U>&& other) noexcept
+        : m_ptr(other.Detach())
+    {
+    }
+
+    ~IntrusivePtr()
+    {
+        if (m_ptr != nullptr)
+            m_ptr->Release();
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    void reset(T* ptr = nullptr)
+    {
+        IntrusivePtr(ptr).swap(*this);
+    }
+
+    void swap(IntrusivePtr& other) noexcept
+    {
+        std::swap(m_ptr, other.m_ptr);
+    }
+
+    // 交出所有权，不减少引用计数
+    T* Detach()
+    {
+        return std::exchange(m_ptr, nullptr);
+    }
+
+    T* get() const { return m_ptr; }
+
+    T* operator->() const { return m_ptr; }
+
+    T& operator*() const { return *m_ptr; }
+
+    explicit operator bool() const { return m_ptr != nullptr; }
+
+    template <typename U>
+    bool operator==(const IntrusivePtr<U>& other) const
+    {
+        return m_ptr == other.get();
+    }
+
+    bool operator==(std::nullptr_t) const
+    {
+        return m_ptr == nullptr;
+    }
+
+private:
+    T* m_ptr = nullptr;
+};
+
+template <typename T, typename... Args>
+inline IntrusivePtr<T> MakeIntrusive(Args&&... args)
+{
+    return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+template <typename T, typename U>
+inline IntrusivePtr<T> StaticPointerCast(const IntrusivePtr<U>& ptr)
+{
+    return IntrusivePtr<T>(static_cast<T*>(ptr.get()));
+}
+} // namespace rtti
+
+template <typename T>
+struct std::hash<rtti::IntrusivePtr<T>>
+{
+    size_t operator()(const rtti::IntrusivePtr<T>& ptr) const noexcept
+    {
+        return std::hash<T*>()(ptr.get());
+    }
+};
@@ -3,23 +3,180 @@
 #include "Object.h"
 #include "ObjectBox.h"
 #include "Attributable.h"
+#include "Arena.h"
+#include <span>
+#include <optional>
+#include <cstring>
 
-namespace
+namespace rtti
 {
-template <typename Tuple, typename Iterator, std::size_t... I>
-static Tuple MakeArgsImpl(const Iterator& p, std::index_sequence<I...>)
+// 调用参数的非持有引用，指向调用方的存储，调用返回前存储须保持有效
+// 值参数记录类型和值的地址；对象参数记录对象本身，装箱对象同时记录其中值的地址
+struct ArgRef
+{
+    Type* ArgType = nullptr;
+    const void* Data = nullptr;
+    Object* Target = nullptr;
+    ObjectPtr (*BoxFunc)(const void* data) = nullptr; // 类型不一致需要转换时装箱
+
+    ArgRef() = default;
+
+    ArgRef(std::nullptr_t)
+    {
+    }
+
+    // 数组和函数须先退化为指针，见 DecayArgument
+    template <typename T>
+        requires(!std::is_same_v<T, ArgRef>)
+    ArgRef(const T& value)
+    {
+        static_assert(!std::is_array_v<T> && !std::is_function_v<T>, "arrays and functions must be decayed to pointers before taking an ArgRef");
+
+        using U = type_t<T>;
+
+        if constexpr (is_object<U>)
+        {
+            static_assert(std::is_same_v<T, Ptr<U>>, "object arguments must be passed as Ptr<T>");
+
+            Target = RTTI_RAW_FROM_PTR(value);
+            if (Target == nullptr)
+                return;
+
+            ArgType = Target->GetType();
+            if constexpr (std::is_same_v<U, Object> || std::is_same_v<U, ObjectBox>)
+            {
+                if (IsValueType(ArgType))
+                    Data = static_cast<ObjectBox*>(Target)->GetPointer();
+            }
+        }
+        else
+        {
+            ArgType = type_of<T>();
+            Data = &value;
+            BoxFunc = [](const void* data) -> ObjectPtr
+            { return Box(*static_cast<const T*>(data)); };
+        }
+    }
+
+    // 转换为 ObjectPtr，值参数会装箱
+    ObjectPtr ToObject() const
+    {
+        if (Target != nullptr)
+            return RTTI_PTR_FROM_RAW(Target);
+        if (BoxFunc != nullptr)
+            return BoxFunc(Data);
+        return nullptr;
+    }
+
+private:
+    // Type 在此处尚不完整，成员访问推迟到实例化时
+    template <typename TType>
+    static bool IsValueType(const TType* type)
+    {
+        return type->IsValueType();
+    }
+};
+
+// 数组和函数实参退化为指针（与按值传参一致），其他实参原样引用
+template <typename T>
+inline decltype(auto) DecayArgument(const T& value)
 {
-    return Tuple(rtti::cast<std::tuple_element_t<I, Tuple>>(p[I])...);
+    if constexpr (std::is_array_v<T> || std::is_function_v<T>)
+        return static_cast<std::decay_t<const T&>>(value);
+    else
+        return (value);
 }
 
-// Convert each ObjectPtr in the Iterator to the type corresponding to Args and place it in a tuple.
-template <typename... Args, typename Iterator>
-static auto MakeArgs(const Iterator& p)
+template <typename... Args>
+inline constexpr bool NeedsDecay = ((std::is_array_v<Args> || std::is_function_v<Args>) || ...);
+} // namespace rtti
+
+namespace
 {
-    static_assert(std::is_same_v<rtti::remove_cr<decltype(p[0])>, rtti::ObjectPtr>, "Iterator type must be ObjectPtr");
+// 读取 A 类型的参数：类型一致时直接引用调用方的存储或装箱对象中的值，否则保存转换后的值
+template <typename A>
+class ArgValue
+{
+public:
+    explicit ArgValue(const rtti::ObjectPtr& arg)
+    {
+        if constexpr (std::is_same_v<A, rtti::ObjectPtr>)
+        {
+            m_value = &arg;
+            return;
+        }
+        else if constexpr (!rtti::is_object<rtti::type_t<A>>)
+        {
+            if (arg != nullptr && arg->GetType() == rtti::type_of<A>())
+            {
+                m_value = &rtti::Unbox<const A&>(arg);
+                return;
+            }
+        }
+
+        m_holder.emplace(rtti::cast<A>(arg));
+        m_value = &*m_holder;
+    }
+
+    explicit ArgValue(const rtti::ArgRef& arg)
+    {
+        using U = rtti::type_t<A>;
 
-    using Tuple = std::tuple<rtti::remove_cr<Args>...>;
-    return MakeArgsImpl<Tuple>(p, std::make_index_sequence<sizeof...(Args)>{});
+        if constexpr (rtti::is_object<U>)
+        {
+            if constexpr (std::is_same_v<A, rtti::Ptr<U>>)
+            {
+                if (arg.Target != nullptr && (std::is_same_v<U, rtti::Object> || rtti::type_of<U>()->IsAssignableFrom(arg.ArgType)))
+                {
+                    m_holder.emplace(RTTI_PTR_CAST(U, RTTI_PTR_FROM_RAW(arg.Target)));
+                    m_value = &*m_holder;
+                    return;
+                }
+            }
+        }
+        else
+        {
+            if (arg.Data != nullptr && arg.ArgType == rtti::type_of<A>())
+            {
+                m_value = static_cast<const A*>(arg.Data);
+                return;
+            }
+        }
+
+        m_holder.emplace(rtti::cast<A>(arg.ToObject()));
+        m_value = &*m_holder;
+    }
+
+    ArgValue(const ArgValue&) = delete;
+    ArgValue& operator=(const ArgValue&) = delete;
+
+    // 按参数的声明传递：const T& 直接引用，按值传递时转换得到的值移动给参数
+    template <typename P>
+    decltype(auto) Pass()
+    {
+        if constexpr (std::is_reference_v<P>)
+            return static_cast<const A&>(*m_value);
+        else
+            return m_holder.has_value() ? A(std::move(*m_holder)) : A(*m_value);
+    }
+
+private:
+    const A* m_value = nullptr;
+    std::optional<A> m_holder;
+};
+
+template <typename... Args, typename F, typename Source, std::size_t... I>
+static auto ApplyArgsImpl(const F& f, [[maybe_unused]] const Source& args, std::index_sequence<I...>)
+{
+    std::tuple<ArgValue<rtti::remove_cr<Args>>...> values{args[I]...};
+    return f(std::get<I>(values).template Pass<Args>()...);
+}
+
+// Read each ObjectPtr / ArgRef in args as the type corresponding to Args and call f with them, the caller checks the count.
+template <typename... Args, typename F, typename Source>
+static auto ApplyArgs(const F& f, const Source& args)
+{
+    return ApplyArgsImpl<Args...>(f, args, std::make_index_sequence<sizeof...(Args)>{});
 }
 
 template <typename T>
@@ -33,6 +190,79 @@ static rtti::ParameterInfo GetParameterInfo()
 
 namespace rtti
 {
+// 作为单个参数传给 Invoke 的类型，参数数组使用 span / vector 重载
+template <typename T>
+concept SingleArgument = !std::is_convertible_v<const T&, std::span<const ArgRef>> && !std::is_convertible_v<const T&, std::span<const ObjectPtr>>;
+
+// 每种函数签名一个唯一的地址，用于比较签名
+template <typename Sig>
+inline const void* GetSignatureId()
+{
+    static const char id = 0;
+    return &id;
+}
+
+template <typename Sig>
+class Invoker;
+
+// 强类型的调用对象：函数指针 + 上下文（注册的成员函数指针），调用时不装箱也不检查类型
+template <typename R, typename... Args>
+class Invoker<R(Args...)>
+{
+public:
+    using Function = R (*)(const void* context, Args... args);
+
+    Invoker() = default;
+
+    Invoker(Function function, const void* context)
+        : m_function(function)
+        , m_context(context)
+    {
+    }
+
+    explicit operator bool() const { return m_function != nullptr; }
+
+    R operator()(Args... args) const
+    {
+        return m_function(m_context, std::forward<Args>(args)...);
+    }
+
+private:
+    Function m_function = nullptr;
+    const void* m_context = nullptr;
+};
+
+// 按值保存注册的函数指针或成员指针，大小足以容纳任意成员函数指针
+class FunctionStorage
+{
+    // 未定义的类，其成员函数指针是最通用（最大）的形式
+    class UnknownClass;
+
+public:
+    static constexpr size_t Size = sizeof(void (UnknownClass::*)());
+
+    FunctionStorage() = default;
+
+    template <typename F>
+    explicit FunctionStorage(F f)
+    {
+        static_assert(sizeof(F) <= Size && std::is_trivially_copyable_v<F>);
+        std::memcpy(m_bytes, &f, sizeof(F));
+    }
+
+    template <typename F>
+    F Get() const
+    {
+        static_assert(sizeof(F) <= Size && std::is_trivially_copyable_v<F>);
+        F f;
+        std::memcpy(&f, m_bytes, sizeof(F));
+        return f;
+    }
+
+private:
+    alignas(void*) unsigned char m_bytes[Size] = {};
+};
+
 class MethodBase : public Attributable
 {
 private:
@@ -64,44 +294,70 @@ public:
 class ConstructorInfo : public MethodBase
 {
 private:
-    std::function<ObjectPtr(const std::vector<ObjectPtr>&)> func;
+    friend class Arena;
+
+    using Thunk = ObjectPtr (*)(const FunctionStorage& func, const std::span<const ObjectPtr>& args);
+    using RefThunk = ObjectPtr (*)(const FunctionStorage& func, const std::span<const ArgRef>& args);
+
+    FunctionStorage func;
+    Thunk thunk;
+    RefThunk refThunk;
 
 protected:
-    ConstructorInfo(Type* owner, std::initializer_list<ParameterInfo> arguments, std::function<ObjectPtr(const std::vector<ObjectPtr>&)> func, const std::map<size_t, std::any>& attributes)
+    ConstructorInfo(Type* owner, std::initializer_list<ParameterInfo> arguments, FunctionStorage func, Thunk thunk, RefThunk refThunk, const std::map<size_t, std::any>& attributes)
         : MethodBase(owner, ".ctor", owner, arguments, attributes)
         , func(func)
+        , thunk(thunk)
+        , refThunk(refThunk)
     {
     }
 
 public:
+    ObjectPtr Invoke(std::span<const ObjectPtr> args)
+    {
+        return thunk(func, args);
+    }
+
     ObjectPtr Invoke(const std::vector<ObjectPtr>& args)
     {
-        return func(args);
+        return thunk(func, args);
     }
 
-    template <typename... Args>
-    ObjectPtr Invoke(Args... arguments)
+    ObjectPtr Invoke(std::initializer_list<ObjectPtr> args)
     {
-        return func({Box(std::forward<Args>(arguments))...});
+        return thunk(func, std::span<const ObjectPtr>(args.begin(), args.size()));
+    }
+
+    // 参数直接从调用方的存储读取，不装箱
+    ObjectPtr Invoke(std::span<const ArgRef> args)
+    {
+        return refThunk(func, args);
     }
 
     template <typename... Args>
-    static ConstructorInfo* Register(Type* host, ObjectPtr (*f)(Args...), const std::map<size_t, std::any>& attributes = {})
+        requires(SingleArgument<Args> && ...)
+    ObjectPtr Invoke(const Args&... arguments)
     {
-        std::function<ObjectPtr(const std::vector<ObjectPtr>&)> func = [=](const std::vector<ObjectPtr>& args) -> ObjectPtr
+        if constexpr (NeedsDecay<Args...>)
         {
-            if (args.size() != sizeof...(Args))
-            {
-                RTTI_ERROR((std::string("requires ") + std::to_string(sizeof...(Args)) + std::string(" parameters, but actually has ") + std::to_string(args.size())).c_str());
-                return nullptr;
-            }
+            // 退化得到的指针是临时对象，存活到本次调用返回
+            return Invoke(DecayArgument(arguments)...);
+        }
+        else if constexpr (sizeof...(Args) == 0)
+        {
+            return refThunk(func, {});
+        }
+        else
+        {
+            const ArgRef refs[] = {ArgRef(arguments)...};
+            return refThunk(func, refs);
+        }
+    }
 
-            auto args_tuple = MakeArgs<Args...>(args);
-            return std::apply([=](Args... args)
-                              { return f(std::forward<Args>(args)...); },
-                              args_tuple);
-        };
-        return new ConstructorInfo(host, {GetParameterInfo<Args>()...}, func, attributes);
+    template <typename... Args>
+    static ConstructorInfo* Register(Type* host, ObjectPtr (*f)(Args...), const std::map<size_t, std::any>& attributes = {})
+    {
+        return GetCurrentArena().New<ConstructorInfo>(host, std::initializer_list<ParameterInfo>{GetParameterInfo<Args>()...}, FunctionStorage(f), &Call<std::span<const ObjectPtr>, Args...>, &Call<std::span<const ArgRef>, Args...>, attributes);
     }
 
     template <typename Host, typename... Args>
@@ -109,6 +365,19 @@ public:
     {
         return Register(type_of<Host>(), f, attributes);
     }
+
+private:
+    template <typename Source, typename... Args>
+    static ObjectPtr Call(const FunctionStorage& func, const Source& args)
+    {
+        if (args.size() != sizeof...(Args))
+        {
+            RTTI_ERROR((std::string("requires ") + std::to_string(sizeof...(Args)) + std::string(" parameters, but actually has ") + std::to_string(args.size())).c_str());
+            return nullptr;
+        }
+
+        return ApplyArgs<Args...>(func.Get<ObjectPtr (*)(Args...)>(), args);
+    }
 };
 
 class MethodInfo : public MethodBase
@@ -120,8 +389,20 @@ private:
         Static = 1
     };
 
+    using Thunk = ObjectPtr (*)(const FunctionStorage& func, const ObjectPtr& target, const std::span<const ObjectPtr>& args);
+    using RefThunk = ObjectPtr (*)(const FunctionStorage& func, const ObjectPtr& target, const std::span<const ArgRef>& args);
+    using BatchThunk = size_t (*)(const FunctionStorage& func, std::span<const ObjectPtr> targets, const std::span<const ArgRef>& args, std::span<ObjectPtr> results);
+
+    // 成员指针与调用函数放在一起，调用时只有一次间接调用
+    FunctionStorage m_func;
+    Thunk m_thunk;
+    RefThunk m_refThunk;
+    BatchThunk m_batchThunk;
     MethodFlags m_flags = MethodFlags::None;
-    std::function<ObjectPtr(const ObjectPtr&, const std::vector<ObjectPtr>&)> m_func;
+
+    // 注册时的签名和强类型调用函数，m_typedFunc 的实际类型由 m_signature 决定
+    const void* m_signature;
+    void (*m_typedFunc)();
 
 public:
     bool IsStatic() const
@@ -129,124 +410,317 @@ public:
         return ((int32_t)m_flags & (int32_t)MethodFlags::Static) != 0;
     }
 
+    ObjectPtr Invoke(const ObjectPtr& target, std::span<const ObjectPtr> args)
+    {
+        return m_thunk(m_func, target, args);
+    }
+
     ObjectPtr Invoke(const ObjectPtr& target, const std::vector<ObjectPtr>& args)
     {
-        return m_func(target, args);
+        return m_thunk(m_func, target, args);
+    }
+
+    ObjectPtr Invoke(const ObjectPtr& target, std::initializer_list<ObjectPtr> args)
+    {
+        return m_thunk(m_func, target, std::span<const ObjectPtr>(args.begin(), args.size()));
+    }
+
+    // 参数直接从调用方的存储读取，不装箱
+    ObjectPtr Invoke(const ObjectPtr& target, std::span<const ArgRef> args)
+    {
+        return m_refThunk(m_func, target, args);
+    }
+
+    template <typename... Args>
+        requires(SingleArgument<Args> && ...)
+    ObjectPtr Invoke(const ObjectPtr& target, const Args&... args)
+    {
+        if constexpr (NeedsDecay<Args...>)
+        {
+            // 退化得到的指针是临时对象，存活到本次调用返回
+            return Invoke(target, DecayArgument(args)...);
+        }
+        else if constexpr (sizeof...(Args) == 0)
+        {
+            return m_refThunk(m_func, target, {});
+        }
+        else
+        {
+            const ArgRef refs[] = {ArgRef(args)...};
+            return m_refThunk(m_func, target, refs);
+        }
+    }
+
+    // 以相同的参数依次调用每个目标，参数只转换一次，连续相同类型的目标只检查一次类型
+    // results 非空时长度不能小于 targets，依次写入返回值（失败时为 nullptr）；返回成功调用的次数
+    size_t InvokeBatch(std::span<const ObjectPtr> targets, std::span<const ArgRef> args, std::span<ObjectPtr> results = {})
+    {
+        return m_batchThunk(m_func, targets, args, results);
     }
 
     template <typename... Args>
-    ObjectPtr Invoke(const ObjectPtr& target, Args... args)
+        requires(SingleArgument<Args> && ...)
+    size_t InvokeBatch(std::span<const ObjectPtr> targets, const Args&... args)
     {
-        return m_func(target, {Box(args)...});
+        if constexpr (NeedsDecay<Args...>)
+        {
+            return InvokeBatch(targets, DecayArgument(args)...);
+        }
+        else if constexpr (sizeof...(Args) == 0)
+        {
+            return m_batchThunk(m_func, targets, {}, {});
+        }
+        else
+        {
+            const ArgRef refs[] = {ArgRef(args)...};
+            return m_batchThunk(m_func, targets, refs, {});
+        }
     }
 
-    MethodInfo(Type* owner, const std::string& name, MethodFlags flags, Type* rettype, std::initializer_list<ParameterInfo> arguments, std::function<ObjectPtr(const ObjectPtr&, const std::vector<ObjectPtr>&)> func, const std::map<size_t, std::any>& attributes)
+    // 签名与注册时完全一致才返回有效的调用对象，只在获取时检查一次
+    // 成员函数 / 字段的签名为 R(Self&, Args...)，Self 为注册的类型；静态函数为 R(Args...)
+    template <typename Sig>
+    Invoker<Sig> TryGetInvoker() const
+    {
+        if (m_signature != GetSignatureId<Sig>())
+            return {};
+
+        return Invoker<Sig>(reinterpret_cast<typename Invoker<Sig>::Function>(m_typedFunc), &m_func);
+    }
+
+    MethodInfo(Type* owner, const std::string& name, MethodFlags flags, Type* rettype, std::initializer_list<ParameterInfo> arguments, FunctionStorage func, Thunk thunk, RefThunk refThunk, BatchThunk batchThunk, const void* signature, void (*typedFunc)(), const std::map<size_t, std::any>& attributes)
         : MethodBase(owner, name, rettype, arguments, attributes)
-        , m_flags(flags)
         , m_func(func)
+        , m_thunk(thunk)
+        , m_refThunk(refThunk)
+        , m_batchThunk(batchThunk)
+        , m_flags(flags)
+        , m_signature(signature)
+        , m_typedFunc(typedFunc)
     {
     }
 
     template <typename Host, typename FUNC, typename RET, typename... Args>
     static MethodInfo* Register(const std::string& name, FUNC f, const std::map<size_t, std::any>& attributes = {})
     {
-        std::function<ObjectPtr(const ObjectPtr&, const std::vector<ObjectPtr>&)> func = [=](const ObjectPtr& target, const std::vector<ObjectPtr>& args) -> ObjectPtr
+        using SelfType = std::remove_pointer_t<Host>;
+
+        Type* rettype;
+        if constexpr (std::is_void_v<RET>)
         {
-            if (args.size() < sizeof...(Args))
-            {
-                RTTI_ERROR((std::string("requires ") + std::to_string(sizeof...(Args)) + std::string(" parameters, but actually has ") + std::to_string(args.size())).c_str());
-                return nullptr;
-            }
+            rettype = nullptr;
+        }
+        else
+        {
+            rettype = type_of<RET>();
+        }
 
-            using SelfType = std::remove_pointer_t<Host>;
+        const void* signature;
+        void (*typedFunc)();
+        if constexpr (std::is_member_function_pointer_v<FUNC> || std::is_member_object_pointer_v<FUNC>)
+        {
+            signature = GetSignatureId<RET(SelfType&, Args...)>();
+            typedFunc = reinterpret_cast<void (*)()>(&InvokeMember<SelfType, FUNC, RET, Args...>);
+        }
+        else
+        {
+            signature = GetSignatureId<RET(Args...)>();
+            typedFunc = reinterpret_cast<void (*)()>(&InvokeStatic<FUNC, RET, Args...>);
+        }
 
-            SelfType* self = nullptr;
-            if constexpr (std::is_member_function_pointer_v<FUNC> || std::is_member_object_pointer_v<FUNC>)
-            {
-                // call menber function / field
-                if (target == nullptr)
-                {
-                    RTTI_ERROR(std::string("target cannot be nullptr").c_str());
-                    return nullptr;
-                }
+        return GetCurrentArena().New<MethodInfo>(type_of<Host>(), name, std::is_member_function_pointer_v<FUNC> ? MethodFlags::None : MethodFlags::Static, rettype, std::initializer_list<ParameterInfo>{GetParameterInfo<Args>()...},
+                                                 FunctionStorage(f), &Call<SelfType, FUNC, RET, std::span<const ObjectPtr>, Args...>, &Call<SelfType, FUNC, RET, std::span<const ArgRef>, Args...>, &CallBatch<SelfType, FUNC, RET, Args...>, signature, typedFunc, attributes);
+    }
 
-                Type* target_type = target->GetRttiType();
+private:
+    template <typename SelfType, typename FUNC, typename RET, typename... Args>
+    static RET InvokeMember(const void* context, SelfType& self, Args... args)
+    {
+        auto f = static_cast<const FunctionStorage*>(context)->Get<FUNC>();
+        if constexpr (std::is_member_function_pointer_v<FUNC>)
+        {
+            return std::invoke(f, &self, std::forward<Args>(args)...);
+        }
+        else if constexpr (std::is_void_v<RET>)
+        {
+            static_assert(sizeof...(Args) == 1);
+            ((self.*f = std::forward<Args>(args)), ...);
+        }
+        else
+        {
+            return self.*f;
+        }
+    }
 
-                if constexpr (is_object<SelfType>)
-                {
-                    if (!type_of<SelfType>()->IsAssignableFrom(target))
-                    {
-                        RTTI_ERROR((std::string("target must be ") + GetTypeName<SelfType>()).c_str());
-                        return nullptr;
-                    }
-                    self = static_cast<SelfType*>(RTTI_RAW_FROM_PTR(target));
-                }
-                else
-                {
-                    if (type_of<SelfType>() != target_type && type_of<SelfType*>() != target_type)
-                    {
-                        RTTI_ERROR((std::string("target must be ") + GetTypeName<SelfType>()).c_str());
-                        return nullptr;
-                    }
-                    self = Unbox<SelfType*>(target);
-                }
+    template <typename FUNC, typename RET, typename... Args>
+    static RET InvokeStatic(const void* context, Args... args)
+    {
+        return std::invoke(static_cast<const FunctionStorage*>(context)->Get<FUNC>(), std::forward<Args>(args)...);
+    }
+
+    // 检查参数和调用目标后，以转换好的参数调用，返回值装箱
+    template <typename SelfType, typename FUNC, typename RET, typename Source, typename... Args>
+    static ObjectPtr Call(const FunctionStorage& func, const ObjectPtr& target, const Source& args)
+    {
+        SelfType* self = nullptr;
+        if (!CheckCall<FUNC>(target, self, args.size(), sizeof...(Args)))
+            return nullptr;
+
+        return ApplyArgs<Args...>([&](Args... a) -> ObjectPtr
+                                  {
+                                      if constexpr (std::is_member_object_pointer_v<FUNC> && !std::is_void_v<RET>)
+                                      {
+                                          // 字段直接装箱，不经过返回值复制
+                                          return cast<ObjectPtr>(self->*func.Get<FUNC>());
+                                      }
+                                      else
+                                      {
+                                          auto invoke = [&]() -> RET
+                                          {
+                                              if constexpr (std::is_member_function_pointer_v<FUNC> || std::is_member_object_pointer_v<FUNC>)
+                                                  return InvokeMember<SelfType, FUNC, RET, Args...>(&func, *self, std::forward<Args>(a)...);
+                                              else
+                                                  return InvokeStatic<FUNC, RET, Args...>(&func, std::forward<Args>(a)...);
+                                          };
+
+                                          if constexpr (std::is_void_v<RET>)
+                                          {
+                                              invoke();
+                                              return nullptr;
+                                          }
+                                          else
+                                          {
+                                              return cast<ObjectPtr>(invoke());
+                                          }
+                                      }
+                                  },
+                                  args);
+    }
+
+    template <typename SelfType, typename FUNC, typename RET, typename... Args>
+    static size_t CallBatch(const FunctionStorage& func, std::span<const ObjectPtr> targets, const std::span<const ArgRef>& args, std::span<ObjectPtr> results)
+    {
+        if (args.size() < sizeof...(Args))
+        {
+            RTTI_ERROR((std::string("requires ") + std::to_string(sizeof...(Args)) + std::string(" parameters, but actually has ") + std::to_string(args.size())).c_str());
+            return 0;
+        }
+
+        if (!results.empty() && results.size() < targets.size())
+        {
+            RTTI_ERROR((std::string("results requires ") + std::to_string(targets.size()) + std::string(" elements, but actually has ") + std::to_string(results.size())).c_str());
+            return 0;
+        }
+
+        // 参数只转换一次，按值传递的参数每次调用时复制
+        return ApplyArgs<Args...>([&](const remove_cr<Args>&... a) -> size_t
+                                  {
+                                      constexpr bool isMember = std::is_member_function_pointer_v<FUNC> || std::is_member_object_pointer_v<FUNC>;
+
+                                      Type* lastType = nullptr;
+                                      bool lastAssignable = false;
+                                      size_t count = 0;
+                                      for (size_t i = 0; i < targets.size(); i++)
+                                      {
+                                          if (!results.empty())
+                                              results[i] = nullptr;
+
+                                          [[maybe_unused]] SelfType* self = nullptr;
+                                          if constexpr (isMember)
+                                          {
+                                              auto& target = targets[i];
+                                              if (target == nullptr)
+                                              {
+                                                  RTTI_ERROR(std::string("target cannot be nullptr").c_str());
+                                                  continue;
+                                              }
+
+                                              Type* targetType = target->GetType();
+                                              if (targetType != lastType)
+                                              {
+                                                  if constexpr (is_object<SelfType>)
+                                                      lastAssignable = type_of<SelfType>()->IsAssignableFrom(targetType);
+                                                  else
+                                                      lastAssignable = type_of<SelfType>() == targetType || type_of<SelfType*>() == targetType;
+                                                  lastType = targetType;
+                                              }
+
+                                              if (!lastAssignable)
+                                              {
+                                                  RTTI_ERROR((std::string("target must be ") + GetTypeName<SelfType>()).c_str());
+                                                  continue;
+                                              }
+
+                                              if constexpr (is_object<SelfType>)
+                                                  self = static_cast<SelfType*>(RTTI_RAW_FROM_PTR(target));
+                                              else
+                                                  self = Unbox<SelfType*>(target);
+                                          }
+
+                                          auto invoke = [&]() -> RET
+                                          {
+                                              if constexpr (isMember)
+                                                  return InvokeMember<SelfType, FUNC, RET, Args...>(&func, *self, a...);
+                                              else
+                                                  return InvokeStatic<FUNC, RET, Args...>(&func, a...);
+                                          };
+
+                                          // 不需要返回值时不装箱
+                                          if constexpr (std::is_void_v<RET>)
+                                              invoke();
+                                          else if (!results.empty())
+                                              results[i] = cast<ObjectPtr>(invoke());
+                                          else
+                                              invoke();
+                                          count++;
+                                      }
+                                      return count;
+                                  },
+                                  args);
+    }
+
+    // 检查参数个数，成员函数 / 字段同时检查并取出调用目标
+    template <typename FUNC, typename SelfType>
+    static bool CheckCall([[maybe_unused]] const ObjectPtr& target, [[maybe_unused]] SelfType*& self, size_t count, size_t required)
+    {
+        if (count < required)
+        {
+            RTTI_ERROR((std::string("requires ") + std::to_string(required) + std::string(" parameters, but actually has ") + std::to_string(count)).c_str());
+            return false;
+        }
+
+        if constexpr (std::is_member_function_pointer_v<FUNC> || std::is_member_object_pointer_v<FUNC>)
+        {
+            // call menber function / field
+            if (target == nullptr)
+            {
+                RTTI_ERROR(std::string("target cannot be nullptr").c_str());
+                return false;
             }
 
-            auto args_tuple = MakeArgs<Args...>(args);
-            if constexpr (std::is_void_v<RET>)
+            Type* target_type = target->GetType();
+
+            if constexpr (is_object<SelfType>)
             {
-                if constexpr (std::is_member_function_pointer_v<FUNC>)
-                {
-                    std::apply([=](Args... a)
-                               { std::invoke(f, self, std::forward<Args>(a)...); },
-                               args_tuple);
-                }
-                else if constexpr (std::is_member_object_pointer_v<FUNC>)
+                if (!type_of<SelfType>()->IsAssignableFrom(target))
                 {
-                    static_assert(sizeof...(Args) == 1);
-                    (self->*f) = std::get<0>(args_tuple);
+                    RTTI_ERROR((std::string("target must be ") + GetTypeName<SelfType>()).c_str());
+                    return false;
                 }
-                else
-                {
-                    std::apply([=](Args... a)
-                               { std::invoke(f, std::forward<Args>(a)...); },
-                               args_tuple);
-                }
-                return nullptr;
+                self = static_cast<SelfType*>(RTTI_RAW_FROM_PTR(target));
             }
             else
             {
-                if constexpr (std::is_member_function_pointer_v<FUNC>)
-                {
-                    return std::apply([=](Args... a)
-                                      { return cast<ObjectPtr>(std::invoke(f, self, std::forward<Args>(a)...)); },
-                                      args_tuple);
-                }
-                else if constexpr (std::is_member_object_pointer_v<FUNC>)
+                if (type_of<SelfType>() != target_type && type_of<SelfType*>() != target_type)
                 {
-                    static_assert(sizeof...(Args) == 0);
-                    return cast<ObjectPtr>(self->*f);
-                }
-                else
-                {
-                    return std::apply([=](Args... a)
-                                      { return cast<ObjectPtr>(std::invoke(f, std::forward<Args>(a)...)); },
-                                      args_tuple);
+                    RTTI_ERROR((std::string("target must be ") + GetTypeName<SelfType>()).c_str());
+                    return false;
                 }
+                self = Unbox<SelfType*>(target);
             }
-        };
-
-        Type* rettype;
-        if constexpr (std::is_void_v<RET>)
-        {
-            rettype = nullptr;
-        }
-        else
-        {
-            rettype = type_of<RET>();
         }
 
-        return new MethodInfo(type_of<Host>(), name, std::is_member_function_pointer_v<FUNC> ? MethodFlags::None : MethodFlags::Static, rettype, {GetParameterInfo<Args>()...}, func, attributes);
+        return true;
     }
 };
 } // namespace rtti
\ No newline at end of file
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "System.h"
 #include "Reflection.h"
+#include <atomic>
 
 namespace rtti
 {
@@ -24,9 +25,30 @@ public:
         return CreateType<Object, void>();
     }
 
+    // 与 GetRttiType() 相同，库内部的类型检查使用此函数
+    Type* GetType() const
+    {
+#if defined(RTTI_OBJECT_TYPE_CACHE)
+        auto type = m_rttiType.load(std::memory_order_acquire);
+        if (type == nullptr)
+        {
+            type = GetRttiType();
+            m_rttiType.store(type, std::memory_order_release);
+        }
+        return type;
+#else
+        return GetRttiType();
+#endif
+    }
+
     virtual ~Object() = default;
 
 public:
     using BASE_TYPE = void;
+
+#if defined(RTTI_OBJECT_TYPE_CACHE)
+protected:
+    mutable std::atomic<Type*> m_rttiType = nullptr;
+#endif
 };
 } // namespace rtti
\ No newline at end of file
@@ -1,5 +1,9 @@
 ﻿#pragma once
+#include <atomic>
+#include <cstdlib>
+#include <limits>
 #include "System.h"
+#include "Pool.h"
 #include "Object.h"
 #include "Reflection.h"
 
@@ -12,6 +16,49 @@ public:
     virtual bool IsPointer() const = 0;
 
     virtual void* GetPointer() = 0;
+
+    // 共享的装箱对象是只读的
+    bool IsReadOnly() const
+    {
+#if defined(RTTI_BOX_CACHE)
+        return m_readOnly;
+#else
+        return false;
+#endif
+    }
+
+protected:
+    template <typename T>
+    friend struct BoxCache;
+
+    // 装箱时保存值的类型，之后的类型检查不再经过 CreateType 的静态变量
+    // 定义 RTTI_OBJECT_TYPE_CACHE 时直接写入 Object 中的类型缓存，不再单独保存
+    explicit ObjectBox(Type* type)
+#if defined(RTTI_OBJECT_TYPE_CACHE)
+    {
+        m_rttiType.store(type, std::memory_order_relaxed);
+    }
+#else
+        : m_type(type)
+    {
+    }
+#endif
+
+    Type* GetBoxedType() const
+    {
+#if defined(RTTI_OBJECT_TYPE_CACHE)
+        return m_rttiType.load(std::memory_order_relaxed);
+#else
+        return m_type;
+#endif
+    }
+
+#if !defined(RTTI_OBJECT_TYPE_CACHE)
+    Type* m_type;
+#endif
+#if defined(RTTI_BOX_CACHE)
+    bool m_readOnly = false;
+#endif
 };
 
 template <typename T>
@@ -25,7 +72,7 @@ public:
 
     virtual rtti::Type* GetRttiType() const override
     {
-        return rtti::CreateType<T, ObjectBox>();
+        return GetBoxedType();
     }
 
     size_t GetHashCode() const override
@@ -41,9 +88,35 @@ private:
 
 public:
     Boxed(const T& _object)
-        : object(_object)
+        : ObjectBox(rtti::CreateType<T, ObjectBox>())
+        , object(_object)
+    {
+    }
+
+    Boxed(T&& _object)
+        : ObjectBox(rtti::CreateType<T, ObjectBox>())
+        , object(std::move(_object))
+    {
+    }
+
+#if defined(RTTI_INTRUSIVE_PTR) && defined(RTTI_BOX_POOL)
+    // 侵入式指针没有分配器参数，装箱对象通过类的 operator new 从对象池分配
+    static void* operator new(size_t size)
+    {
+        if constexpr (alignof(Boxed) > Pool::Granularity)
+            return ::operator new(size, std::align_val_t(alignof(Boxed)));
+        else
+            return Pool::Allocate(size);
+    }
+
+    static void operator delete(void* ptr, size_t size)
     {
+        if constexpr (alignof(Boxed) > Pool::Granularity)
+            ::operator delete(ptr, std::align_val_t(alignof(Boxed)));
+        else
+            Pool::Deallocate(ptr, size);
     }
+#endif
 
     T& Unbox()
     {
@@ -61,10 +134,92 @@ public:
     }
 };
 
+// 右值参数移动到装箱对象中
+template <typename T>
+inline Ptr<Boxed<std::decay_t<T>>> MakeBox(T&& value)
+{
+    return RTTI_MAKE_BOX(Boxed<std::decay_t<T>>, std::forward<T>(value));
+}
+
+#if defined(RTTI_BOX_CACHE)
+// 每种 bool / 整数 / 枚举类型各有一组共享的装箱对象，按值懒创建，创建后不再释放
+template <typename T>
+struct BoxCache
+{
+    using Underlying = typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T>>::type;
+
+    static constexpr bool Enabled = std::is_integral_v<T> || std::is_enum_v<T>;
+    static constexpr int64_t Min = std::max<int64_t>(RTTI_BOX_CACHE_MIN, std::is_signed_v<Underlying> ? (int64_t)std::numeric_limits<Underlying>::min() : 0);
+    static constexpr int64_t Max = std::min<int64_t>(RTTI_BOX_CACHE_MAX, std::numeric_limits<Underlying>::max() > (uint64_t)INT64_MAX ? INT64_MAX : (int64_t)std::numeric_limits<Underlying>::max());
+
+    // 超出范围或未注册的枚举值返回 nullptr
+    static const ObjectPtr* Get(T value)
+    {
+        auto v = static_cast<int64_t>(value);
+        if (v < Min || v > Max)
+            return nullptr;
+
+        auto& slot = GetSlots()[v - Min];
+        auto box = slot.load(std::memory_order_acquire);
+        if (box != nullptr)
+            return box;
+
+        if constexpr (std::is_enum_v<T>)
+        {
+            if (type_of<T>()->FindEnumInfo(v) == nullptr)
+                return nullptr;
+        }
+
+        auto boxed = MakeBox(value);
+        boxed->m_readOnly = true;
+        auto newBox = new ObjectPtr(boxed);
+        if (slot.compare_exchange_strong(box, newBox, std::memory_order_acq_rel))
+            return newBox;
+
+        delete newBox;
+        return box;
+    }
+
+    static std::atomic<ObjectPtr*>* GetSlots()
+    {
+        static auto slots = new std::atomic<ObjectPtr*>[Max - Min + 1]();
+        return slots;
+    }
+};
+#endif
+
+template <typename T>
+    requires ValueType<std::decay_t<T>>
+inline ObjectPtr Box(T&& value)
+{
+#if defined(RTTI_BOX_CACHE)
+    using U = std::decay_t<T>;
+    if constexpr (BoxCache<U>::Enabled)
+    {
+        if (auto box = BoxCache<U>::Get(value))
+            return *box;
+    }
+#endif
+    return MakeBox(std::forward<T>(value));
+}
+
+// 显式指定类型时（如 Box<int>(x)）左值参数复制一份后装箱
 template <ValueType T>
-inline ObjectPtr Box(T value)
+inline ObjectPtr Box(const T& value)
 {
-    return rtti::MakePtr<Boxed<T>>(value);
+    return Box(T(value));
+}
+
+// 通过引用或指针修改共享的只读装箱对象会影响所有使用者，发布版本中同样终止程序
+inline void CheckWritable([[maybe_unused]] ObjectBox* box)
+{
+#if defined(RTTI_BOX_CACHE)
+    if (box->IsReadOnly())
+    {
+        RTTI_ERROR("shared boxes are read-only, box a copy before taking a mutable reference");
+        std::abort();
+    }
+#endif
 }
 
 //  Unbox<int>(...)   int   int&   int*
@@ -90,7 +245,7 @@ inline T Unbox(const ObjectPtr& ptr)
             else
             {
                 // Unbox<int*>(int*)
-                assert(ptr->GetRttiType() == type_of<T>());
+                assert(ptr->GetType() == type_of<T>());
                 auto boxed = static_cast<Boxed<T>*>(objbox);
                 return boxed->Unbox();
             }
@@ -100,20 +255,25 @@ inline T Unbox(const ObjectPtr& ptr)
             if constexpr (!std::is_void_v<std::remove_pointer_t<T>>)
             {
                 // Unbox<int*>(int)
-                assert(ptr->GetRttiType() == type_of<std::remove_pointer_t<T>>());
+                assert(ptr->GetType() == type_of<std::remove_pointer_t<T>>());
+                if constexpr (!std::is_const_v<std::remove_pointer_t<T>>)
+                    CheckWritable(objbox);
                 auto boxed = static_cast<Boxed<std::remove_pointer_t<T>>*>(objbox);
                 return &boxed->Unbox();
             }
             else
             {
                 // Unbox<void*>(...)
+                CheckWritable(objbox);
                 return objbox->GetPointer();
             }
         }
     }
     else if constexpr (std::is_reference_v<T>)
     {
-        assert(ptr->GetRttiType() == type_of<T>());
+        assert(ptr->GetType() == type_of<T>());
+        if constexpr (!std::is_const_v<std::remove_reference_t<T>>)
+            CheckWritable(objbox);
         auto boxed = static_cast<Boxed<remove_cr<T>>*>(objbox);
         return boxed->Unbox();
     }
@@ -0,0 +1,247 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace rtti
+{
+// 小对象池：按 16 字节划分大小类，每个线程从自己的堆（按大小类划分的 slab）中分配，不加锁
+// 其他线程释放的块放入所属堆的无锁链表，由所属线程下次分配时回收
+// 线程退出后堆交给之后新建的线程接管；slab 不归还给系统
+class Pool
+{
+public:
+    static constexpr size_t Granularity = 16;
+    static constexpr size_t MaxSize = 256;
+    static constexpr size_t ClassCount = MaxSize / Granularity;
+    static constexpr size_t SlabSize = 64 * 1024;
+
+    static void* Allocate(size_t size)
+    {
+        if (size > MaxSize)
+            return ::operator new(size);
+
+        auto sizeClass = GetSizeClass(size);
+        if (auto heap = GetThreadHeap(true))
+            return heap->Allocate(sizeClass);
+
+        // 线程退出过程中的分配使用共享堆
+        auto& shared = GetSharedHeap();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        return shared.heap.Allocate(sizeClass);
+    }
+
+    static void Deallocate(void* ptr, size_t size)
+    {
+        if (size > MaxSize)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        auto slab = Slab::From(ptr);
+        if (slab->owner == GetThreadHeap(false))
+            slab->owner->FreeLocal(ptr, slab->sizeClass);
+        else
+            slab->owner->FreeRemote(ptr, slab->sizeClass);
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct Heap;
+
+    // slab 按 SlabSize 对齐，块地址向下取整即得到所属 slab
+    struct Slab
+    {
+        static constexpr size_t HeaderSize = 64;
+
+        Heap* owner;
+        size_t sizeClass;
+
+        static Slab* From(void* ptr)
+        {
+            return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t)(SlabSize - 1));
+        }
+    };
+
+    struct Heap
+    {
+        FreeBlock* local[ClassCount] = {};
+        std::atomic<FreeBlock*> remote[ClassCount] = {};
+        std::byte* bump[ClassCount] = {};
+        std::byte* bumpEnd[ClassCount] = {};
+
+        void* Allocate(size_t sizeClass)
+        {
+            if (auto block = local[sizeClass])
+            {
+                local[sizeClass] = block->next;
+                return block;
+            }
+
+            // 一次取走其他线程释放的全部块
+            if (auto block = remote[sizeClass].exchange(nullptr, std::memory_order_acquire))
+            {
+                local[sizeClass] = block->next;
+                return block;
+            }
+
+            size_t blockSize = (sizeClass + 1) * Granularity;
+            if (bump[sizeClass] == nullptr || bump[sizeClass] + blockSize > bumpEnd[sizeClass])
+            {
+                auto memory = static_cast<std::byte*>(::operator new(SlabSize, std::align_val_t(SlabSize)));
+                ::new (memory) Slab{this, sizeClass};
+                bump[sizeClass] = memory + Slab::HeaderSize;
+                bumpEnd[sizeClass] = memory + SlabSize;
+            }
+
+            auto block = bump[sizeClass];
+            bump[sizeClass] += blockSize;
+            return block;
+        }
+
+        void FreeLocal(void* ptr, size_t sizeClass)
+        {
+            auto block = static_cast<FreeBlock*>(ptr);
+            block->next = local[sizeClass];
+            local[sizeClass] = block;
+        }
+
+        void FreeRemote(void* ptr, size_t sizeClass)
+        {
+            auto block = static_cast<FreeBlock*>(ptr);
+            auto head = remote[sizeClass].load(std::memory_order_relaxed);
+            do
+            {
+                block->next = head;
+            } while (!remote[sizeClass].compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+        }
+    };
+
+    struct SharedHeap
+    {
+        std::mutex mutex;
+        Heap heap;
+    };
+
+    // 以下全局状态不析构，静态对象析构期间仍可释放
+    static SharedHeap& GetSharedHeap()
+    {
+        static auto shared = new SharedHeap();
+        return *shared;
+    }
+
+    struct OrphanList
+    {
+        std::mutex mutex;
+        std::vector<Heap*> heaps;
+    };
+
+    static OrphanList& GetOrphanList()
+    {
+        static auto orphans = new OrphanList();
+        return *orphans;
+    }
+
+    // 线程退出时把堆放入孤儿列表，堆中仍在使用的块之后由其他线程释放到 remote 链表
+    struct ThreadHeapOwner
+    {
+        Heap* heap;
+
+        ~ThreadHeapOwner()
+        {
+            GetThreadHeapSlot() = nullptr;
+            GetThreadExited() = true;
+
+            auto& orphans = GetOrphanList();
+            std::lock_guard<std::mutex> lock(orphans.mutex);
+            orphans.heaps.push_back(heap);
+        }
+    };
+
+    static Heap*& GetThreadHeapSlot()
+    {
+        thread_local Heap* heap = nullptr;
+        return heap;
+    }
+
+    static bool& GetThreadExited()
+    {
+        thread_local bool exited = false;
+        return exited;
+    }
+
+    static Heap* AdoptHeap()
+    {
+        auto& orphans = GetOrphanList();
+        std::lock_guard<std::mutex> lock(orphans.mutex);
+        if (orphans.heaps.empty())
+            return new Heap();
+
+        auto heap = orphans.heaps.back();
+        orphans.heaps.pop_back();
+        return heap;
+    }
+
+    // 线程退出后返回 nullptr
+    static Heap* GetThreadHeap(bool create)
+    {
+        auto heap = GetThreadHeapSlot();
+        if (heap != nullptr || !create || GetThreadExited())
+            return heap;
+
+        thread_local ThreadHeapOwner owner{AdoptHeap()};
+        GetThreadHeapSlot() = owner.heap;
+        return owner.heap;
+    }
+
+    static constexpr size_t GetSizeClass(size_t size)
+    {
+        return size == 0 ? 0 : (size - 1) / Granularity;
+    }
+};
+
+// 从 Pool 分配的标准分配器，用于 std::allocate_shared
+template <typename T>
+struct PoolAllocator
+{
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if constexpr (alignof(T) > Pool::Granularity)
+            return std::allocator<T>().allocate(n);
+        else
+            return static_cast<T*>(Pool::Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        if constexpr (alignof(T) > Pool::Granularity)
+            std::allocator<T>().deallocate(ptr, n);
+        else
+            Pool::Deallocate(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept
+    {
+        return true;
+    }
+};
+} // namespace rtti
@@ -13,6 +13,8 @@ private:
     template <typename T, bool>
     friend struct TypeRegister;
 
+    friend class Arena;
+
 private:
     Type* owner;
     std::string name;
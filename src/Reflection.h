@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+#include <mutex>
 #include "nameof.hpp"
 #include "System.h"
 
@@ -111,7 +113,21 @@ inline Type* CreateType()
     {
         static_assert(std::is_same_v<BASE, ObjectBox>);
         static Type* type = NewType(GetTypeName<CLS>(), sizeof(CLS), TypeFlags::Enum, type_of<typename std::underlying_type_t<CLS>>(), type_of<BASE>());
-        DefaultEnumRegister<CLS>(type);
+
+        // 默认注册只执行一次；注册过程中会再次进入 type_of<CLS>()，此时直接返回
+        static std::atomic<bool> registered = false;
+        if (!registered.load(std::memory_order_acquire))
+        {
+            static std::recursive_mutex mutex;
+            static bool registering = false;
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            if (!registering)
+            {
+                registering = true;
+                DefaultEnumRegister<CLS>(type);
+                registered.store(true, std::memory_order_release);
+            }
+        }
         return type;
     }
     else if constexpr (std::is_integral_v<CLS>)
@@ -8,10 +8,12 @@
 #include <type_traits>
 #include <cassert>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <functional>
 
 #include "Config.h"
+#include "IntrusivePtr.h"
 
 namespace rtti
 {
@@ -61,6 +63,13 @@ constexpr size_t HashString(const char* str, size_t seed = 0)
 template <auto V>
 static constexpr auto force_consteval = V;
 
+constexpr size_t HashString(std::string_view str, size_t seed = 0)
+{
+    for (char c : str)
+        seed = seed ^ (c + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    return seed;
+}
+
 #define HASH(str) rtti::force_consteval<rtti::HashString(str)>
 
 template <typename T>
@@ -1,5 +1,12 @@
 ﻿#pragma once
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <span>
+#include "Concurrent.h"
+#include "Arena.h"
 #include "Object.h"
 #include "ObjectBox.h"
 #include "Attributable.h"
@@ -9,6 +16,39 @@
 namespace rtti
 {
 
+// 类型在进程内的连续整数编号，按创建顺序从 0 开始分配
+using TypeId = uint32_t;
+
+// 枚举值
+struct EnumInfo
+{
+    int64_t Value;
+    std::string_view Name;
+};
+
+// 以 EnumInfo::Name 为键的开放寻址哈希表，slots.size() 为 2 的幂且大于 infos.size()
+// slots[i] 为 infos 下标 + 1，0 表示空
+constexpr void BuildEnumNameSlots(std::span<const EnumInfo> infos, std::span<uint32_t> slots)
+{
+    size_t mask = slots.size() - 1;
+    for (uint32_t i = 0; i < infos.size(); i++)
+    {
+        size_t slot = HashString(infos[i].Name) & mask;
+        while (slots[slot] != 0)
+            slot = (slot + 1) & mask;
+        slots[slot] = i + 1;
+    }
+}
+
+// 开放寻址哈希表的槽位数，2 的幂且不小于 count 的两倍
+constexpr size_t GetHashSlotCount(size_t count)
+{
+    size_t size = 1;
+    while (size < count * 2)
+        size <<= 1;
+    return size;
+}
+
 using Convertor = bool (*)(const ObjectPtr& obj, Type* targetType, ObjectPtr& target);
 
 struct TypeConvertor
@@ -16,6 +56,8 @@ struct TypeConvertor
     // Type* SourceType;
     Type* TargetType;
     Convertor Convert;
+    // 注册时所在的 arena，Release() 时随之移除（转换函数可能位于被卸载的模块中）
+    Arena* Owner = nullptr;
 };
 
 enum class CompareResult
@@ -32,6 +74,23 @@ struct ObjectComparer
     // Type* SourceType;
     Type* TargetType;
     Comparer Compare;
+    // 注册时所在的 arena
+    Arena* Owner = nullptr;
+};
+
+enum class AttributeTargetKind : uint8_t
+{
+    Type,
+    Constructor,
+    Method,
+    Property,
+};
+
+// 带有某一特性的类型或成员，Target 按 Kind 转换为 Type / ConstructorInfo / MethodInfo / PropertyInfo
+struct AttributeTarget
+{
+    AttributeTargetKind Kind;
+    Attributable* Target;
 };
 
 class Type : public Attributable
@@ -45,23 +104,47 @@ private:
 
     friend Type* NewType(const std::string& name, size_t size, TypeFlags flags, Type* underlyingType, Type* base);
 
+    friend class Arena;
+
     Type(const std::string& name, size_t size, TypeFlags flags, Type* underlyingType, Type* baseType, const std::map<size_t, std::any>& attributes)
         : Attributable(attributes)
-        , m_name(name)
         , m_size((uint32_t)size)
         , m_flags(flags)
         , m_baseType(baseType)
         , m_underlyingType(underlyingType)
-        , next(header)
     {
-        header = this;
+        m_name.Publish(new std::string(name));
+
+        if (baseType != nullptr)
+            m_ancestors = baseType->m_ancestors;
+        m_ancestors.push_back(this);
+
+        // 其他字段都已写好，加锁后依次发布到编号表、链表和名称索引
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+
+        auto& types = GetTypeTable();
+        m_id = (TypeId)types.size();
+        types.Add(this);
+
+        next = header.load(std::memory_order_relaxed);
+        header.store(this, std::memory_order_release);
+
+        IndexName(this);
+
+        // 新类型与冻结的类型同名时，冻结的名称表不再准确
+        auto frozen = GetFrozenRegistry().Load();
+        if (frozen != nullptr && FindFrozenSlot(frozen->typeSlots, name) != nullptr)
+            OnFrozenModified();
     }
 
     ~Type() {}
 
 public:
+    // 类型编号
+    TypeId GetId() const { return m_id; }
+
     // 类型名称
-    const std::string& GetName() const { return m_name; }
+    const std::string& GetName() const { return *m_name.Load(); }
 
     // 类型大小
     size_t GetSize() const { return m_size; }
@@ -72,17 +155,18 @@ public:
     // 基类型
     Type* GetBaseType() const { return m_baseType; }
 
+    // 继承深度，根类型为 0
+    size_t GetDepth() const { return m_ancestors.size() - 1; }
+
     // 当前类型是否是type的子类
     bool IsSubClassOf(Type* type) const
     {
-        auto t = this;
-        do
-        {
-            t = t->GetBaseType();
-            if (t == type)
-                return true;
-        } while (t != nullptr);
-        return false;
+        // 所有继承链都终止于 nullptr
+        if (type == nullptr)
+            return true;
+
+        auto depth = type->GetDepth();
+        return depth < GetDepth() && m_ancestors[depth] == type;
     }
 
     template <typename T>
@@ -111,33 +195,77 @@ public:
         return ((int)m_flags & (int)flag) != 0;
     }
 
-    const std::map<std::string, ObjectPtr>& GetEnumInfos() const
+    // 枚举值，按值排序
+    std::span<const EnumInfo> GetEnumInfos() const
     {
-        return m_enumValues;
+        auto table = m_enumTable.Load();
+        return table != nullptr ? table->infos : std::span<const EnumInfo>();
     }
 
-    std::string GetEnumName(const ObjectPtr& value) const
+    const EnumInfo* FindEnumInfo(int64_t value) const
     {
-        for (auto&& i : m_enumValues)
+        auto table = m_enumTable.Load();
+        if (table == nullptr || table->infos.empty())
+            return nullptr;
+
+        auto infos = table->infos;
+        if (table->dense)
         {
-            if (Compare(i.second, value) == CompareResult::Equals)
-            {
-                return i.first;
-            }
+            auto offset = (uint64_t)value - (uint64_t)infos.front().Value;
+            return offset < infos.size() ? &infos[offset] : nullptr;
+        }
+
+        auto it = std::lower_bound(infos.begin(), infos.end(), value, [](const EnumInfo& info, int64_t v) { return info.Value < v; });
+        return it != infos.end() && it->Value == value ? &*it : nullptr;
+    }
+
+    const EnumInfo* FindEnumInfo(std::string_view name) const
+    {
+        auto table = m_enumTable.Load();
+        if (table == nullptr || table->slots.empty())
+            return nullptr;
+
+        size_t mask = table->slots.size() - 1;
+        for (size_t i = HashString(name) & mask;; i = (i + 1) & mask)
+        {
+            auto slot = table->slots[i];
+            if (slot == 0)
+                return nullptr;
+            if (table->infos[slot - 1].Name == name)
+                return &table->infos[slot - 1];
         }
-        return std::string();
     }
 
-    ObjectPtr GetEnumValue(const std::string& name) const
+    std::string_view GetEnumName(int64_t value) const
+    {
+        auto info = FindEnumInfo(value);
+        return info != nullptr ? info->Name : std::string_view();
+    }
+
+    std::string GetEnumName(const ObjectPtr& value) const
     {
-        for (auto&& i : m_enumValues)
+        auto infos = GetEnumInfos();
+        if (value == nullptr || infos.empty())
+            return std::string();
+
+        if (value->GetType() == this)
+            return std::string(GetEnumName(m_enumUnbox(value)));
+
+        // 其他类型的值，通过注册的比较器逐个比较
+        for (auto&& i : infos)
         {
-            if (i.first == name)
+            if (Compare(m_enumBox(i.Value), value) == CompareResult::Equals)
             {
-                return i.second;
+                return std::string(i.Name);
             }
         }
-        return nullptr;
+        return std::string();
+    }
+
+    ObjectPtr GetEnumValue(std::string_view name) const
+    {
+        auto info = FindEnumInfo(name);
+        return info != nullptr ? m_enumBox(info->Value) : nullptr;
     }
 
     bool IsAssignableFrom(Type* type) const
@@ -159,7 +287,7 @@ public:
         if (obj == nullptr)
             return !IsValueType();
 
-        return IsAssignableFrom(obj->GetRttiType());
+        return IsAssignableFrom(obj->GetType());
     }
 
     bool IsAssignableTo(Type* type) const
@@ -185,33 +313,7 @@ public:
     // 当前类型能否转换为目标类型，只支持单次转换
     bool CanConvertTo(Type* targetType) const
     {
-        Type* sourceType = const_cast<Type*>(this);
-
-        if (targetType->IsAssignableFrom(sourceType))
-            return true;
-
-        if (sourceType->IsPointer() && targetType == type_of<void*>())
-            return true;
-
-        if (sourceType->IsEnum() && targetType->HasFlag(TypeFlags::Integral))
-            return true;
-
-        if (sourceType->HasFlag(TypeFlags::Integral) && targetType->IsEnum())
-            return true;
-
-        for (auto&& i : targetType->m_constructors)
-        {
-            if (i->GetParameters().size() == 1 && i->GetParameters()[0].ParameterType->IsAssignableFrom(sourceType))
-                return true;
-        }
-
-        for (auto&& i : m_typeConvertors)
-        {
-            if (i.TargetType->IsAssignableTo(targetType))
-                return true;
-        }
-
-        return false;
+        return GetConvertPlan(targetType).kind != ConvertKind::None;
     }
 
     template <typename T>
@@ -221,62 +323,48 @@ public:
     }
 
     // 创建当前类型的实例
+    ObjectPtr CreateInstance(std::span<const ObjectPtr> args) const
+    {
+        auto ctor = FindConstructor(args);
+        return ctor != nullptr ? ctor->Invoke(args) : nullptr;
+    }
+
     ObjectPtr CreateInstance(const std::vector<ObjectPtr>& args) const
     {
-        for (size_t i = 0; i < m_constructors.size(); i++)
-        {
-            auto ctor = m_constructors[i];
-            if (ctor->GetParameters().size() == args.size())
-            {
-                bool ok = true;
-                for (size_t j = 0; j < args.size(); j++)
-                {
-                    auto pt = ctor->GetParameters()[j];
-                    if (pt.ParameterType->IsValueType())
-                    {
-                        if (args[j] == nullptr || args[j]->GetRttiType() != pt.ParameterType)
-                        {
-                            ok = false;
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        if (args[j] != nullptr && !args[j]->GetRttiType()->CanConvertTo(pt.ParameterType))
-                        {
-                            ok = false;
-                            break;
-                        }
-                    }
-                }
-                if (ok)
-                {
-                    return ctor->Invoke(args);
-                }
-            }
-        }
-        return nullptr;
+        return CreateInstance(std::span<const ObjectPtr>(args));
     }
 
-    // 创建当前类型的实例
+    ObjectPtr CreateInstance(std::initializer_list<ObjectPtr> args) const
+    {
+        return CreateInstance(std::span<const ObjectPtr>(args.begin(), args.size()));
+    }
+
+    // 创建当前类型的实例，参数放在栈上的数组中
     template <typename T = Object, typename... Args>
     Ptr<T> Create(Args&&... args) const
     {
-        return RTTI_PTR_CAST(T, CreateInstance({cast<ObjectPtr>(args)...}));
+        if constexpr (sizeof...(Args) == 0)
+        {
+            return RTTI_PTR_CAST(T, CreateInstance(std::span<const ObjectPtr>()));
+        }
+        else
+        {
+            const ObjectPtr objects[] = {cast<ObjectPtr>(args)...};
+            return RTTI_PTR_CAST(T, CreateInstance(std::span<const ObjectPtr>(objects)));
+        }
     }
 
-    // 获取类型的构造函数
-    const std::vector<ConstructorInfo*>& GetConstructors() const
+    // 获取类型的构造函数，之后注册的构造函数不会出现在已返回的 span 中
+    std::span<ConstructorInfo* const> GetConstructors() const
     {
-        return m_constructors;
+        return m_constructors.Get();
     }
 
     // 获取类型的构造函数
     ConstructorInfo* GetConstructor() const
     {
-        for (size_t i = 0; i < m_constructors.size(); i++)
+        for (auto ctor : m_constructors.Get())
         {
-            auto ctor = m_constructors[i];
             if (0 == ctor->GetParameters().size())
             {
                 return ctor;
@@ -287,9 +375,8 @@ public:
 
     ConstructorInfo* GetConstructor(std::initializer_list<Type*> args) const
     {
-        for (size_t i = 0; i < m_constructors.size(); i++)
+        for (auto ctor : m_constructors.Get())
         {
-            auto ctor = m_constructors[i];
             if (args.size() == ctor->GetParameters().size())
             {
                 bool paramMatch = true;
@@ -311,9 +398,8 @@ public:
 
     ConstructorInfo* GetConstructor(std::initializer_list<ParameterInfo> args) const
     {
-        for (size_t i = 0; i < m_constructors.size(); i++)
+        for (auto ctor : m_constructors.Get())
         {
-            auto ctor = m_constructors[i];
             if (args.size() == ctor->GetParameters().size())
             {
                 bool paramMatch = true;
@@ -334,126 +420,90 @@ public:
         return nullptr;
     }
 
-    // 遍历类型的方法
-    std::vector<MethodInfo*> GetMethods() const
+    // 遍历类型的方法（含基类），再次注册成员后之前返回的 span 失效
+    std::span<MethodInfo* const> GetMethods() const
     {
-        std::vector<MethodInfo*> methods;
-        const Type* curType = this;
-        while (curType != nullptr)
-        {
-            methods.insert(methods.end(), curType->m_methods.begin(), curType->m_methods.end());
-            curType = curType->GetBaseType();
-        }
-        return methods;
+        if (auto frozen = GetFrozenMembers())
+            return frozen->allMethods;
+        return GetMemberTable().allMethods;
     }
 
     // 获取类型的方法
-    MethodInfo* GetMethod(const std::string& name) const
+    MethodInfo* GetMethod(std::string_view name) const
     {
-        auto curType = this;
-        while (curType != nullptr)
-        {
-            for (size_t i = 0; i < curType->m_methods.size(); i++)
-            {
-                auto m = curType->m_methods[i];
-                if (m->GetName() == name)
-                {
-                    return m;
-                }
-            }
-            curType = curType->GetBaseType();
-        }
-        return nullptr;
+        auto methods = FindMethods(name);
+        return methods.empty() ? nullptr : methods.front();
     }
 
-    MethodInfo* GetMethod(const std::string& name, std::initializer_list<Type*> args) const
+    MethodInfo* GetMethod(std::string_view name, std::initializer_list<Type*> args) const
     {
-        auto curType = this;
-        while (curType != nullptr)
+        for (auto m : FindMethods(name))
         {
-            for (size_t i = 0; i < curType->m_methods.size(); i++)
+            if (args.size() == m->GetParameters().size())
             {
-                auto m = curType->m_methods[i];
-                if (m->GetName() == name && args.size() == m->GetParameters().size())
+                bool paramMatch = true;
+                for (size_t j = 0; j < m->GetParameters().size(); j++)
                 {
-                    bool paramMatch = true;
-                    for (size_t j = 0; j < m->GetParameters().size(); j++)
+                    auto p = m->GetParameters()[j];
+                    if (p.ParameterType != args.begin()[j])
                     {
-                        auto p = m->GetParameters()[j];
-                        if (p.ParameterType != args.begin()[j])
-                        {
-                            paramMatch = false;
-                            break;
-                        }
+                        paramMatch = false;
+                        break;
                     }
-
-                    if (paramMatch)
-                        return m;
                 }
+
+                if (paramMatch)
+                    return m;
             }
-            curType = curType->GetBaseType();
         }
         return nullptr;
     }
 
-    MethodInfo* GetMethod(const std::string& name, std::initializer_list<ParameterInfo> args) const
+    MethodInfo* GetMethod(std::string_view name, std::initializer_list<ParameterInfo> args) const
     {
-        auto curType = this;
-        while (curType != nullptr)
+        for (auto m : FindMethods(name))
         {
-            for (size_t i = 0; i < curType->m_methods.size(); i++)
+            if (args.size() == m->GetParameters().size())
             {
-                auto m = curType->m_methods[i];
-                if (m->GetName() == name && args.size() == m->GetParameters().size())
+                bool paramMatch = true;
+                for (size_t j = 0; j < m->GetParameters().size(); j++)
                 {
-                    bool paramMatch = true;
-                    for (size_t j = 0; j < m->GetParameters().size(); j++)
+                    const auto& p = m->GetParameters()[j];
+                    const auto& ap = args.begin()[j];
+                    if (p.ParameterType != ap.ParameterType || p.IsConst != ap.IsConst || p.IsRef != ap.IsRef)
                     {
-                        const auto& p = m->GetParameters()[j];
-                        const auto& ap = args.begin()[j];
-                        if (p.ParameterType != ap.ParameterType || p.IsConst != ap.IsConst || p.IsRef != ap.IsRef)
-                        {
-                            paramMatch = false;
-                            break;
-                        }
+                        paramMatch = false;
+                        break;
                     }
-
-                    if (paramMatch)
-                        return m;
                 }
+
+                if (paramMatch)
+                    return m;
             }
-            curType = curType->GetBaseType();
         }
         return nullptr;
     }
 
-    // 遍历类型的属性
-    std::vector<PropertyInfo*> GetProperties() const
+    // 遍历类型的属性（含基类），再次注册成员后之前返回的 span 失效
+    std::span<PropertyInfo* const> GetProperties() const
     {
-        std::vector<PropertyInfo*> rets;
-        const Type* curType = this;
-        while (curType != nullptr)
-        {
-            rets.insert(rets.end(), curType->m_properties.begin(), curType->m_properties.end());
-            curType = curType->GetBaseType();
-        }
-        return rets;
+        if (auto frozen = GetFrozenMembers())
+            return frozen->allProperties;
+        return GetMemberTable().allProperties;
     }
 
     // 获取类型的属性
-    PropertyInfo* GetProperty(const std::string& name) const
+    PropertyInfo* GetProperty(std::string_view name) const
     {
-        auto curType = this;
-        while (curType != nullptr)
+        if (auto frozen = GetFrozenMembers())
         {
-            for (size_t i = 0; i < curType->m_properties.size(); i++)
-            {
-                if (curType->m_properties[i]->GetName() == name)
-                    return curType->m_properties[i];
-            }
-            curType = curType->GetBaseType();
+            auto slot = FindFrozenSlot(frozen->propertySlots, name);
+            return slot != nullptr ? frozen->allProperties[slot->first] : nullptr;
         }
-        return nullptr;
+
+        const auto& properties = GetMemberTable().properties;
+        auto it = properties.find(name);
+        return it != properties.end() ? it->second : nullptr;
     }
 
     // 将 obj 转换为目标类型，只支持单次转换
@@ -469,165 +519,1047 @@ public:
             return false;
         }
 
-        Type* sourceType = obj->GetRttiType();
+        Type* sourceType = obj->GetType();
+        return sourceType->ApplyConvertPlan(sourceType->GetConvertPlan(targetType), obj, targetType, target);
+    }
 
-        if (targetType->IsAssignableFrom(sourceType))
+    // 比较 left 和 right
+    static bool IsComparable(Type* leftType, Type* rightType)
+    {
+        if (leftType == nullptr)
         {
-            target = obj;
-            return true;
+            if (rightType == nullptr)
+                return true;
+            else
+                return Type::IsComparable(rightType, leftType);
         }
 
-        if (sourceType->IsPointer() && targetType == type_of<void*>())
-        {
-            target = rtti::Box(rtti::Unbox<void*>(obj));
-            return true;
-        }
+        return leftType->GetComparePlan(rightType).comparer != ComparePlan::NoComparer;
+    }
 
-        for (auto&& i : targetType->m_constructors)
+    static CompareResult Compare(const ObjectPtr& left, const ObjectPtr& right)
+    {
+        if (left == nullptr)
         {
-            if (i->GetParameters().size() == 1 && i->GetParameters()[0].ParameterType->IsAssignableFrom(sourceType))
-            {
-                target = targetType->CreateInstance({obj});
-                if (target != nullptr)
-                    return true;
-            }
+            if (right == nullptr)
+                return CompareResult::Equals;
+            else
+                return Type::Compare(right, left);
         }
 
-        for (auto&& i : sourceType->m_typeConvertors)
-        {
-            if (i.TargetType->IsAssignableTo(targetType))
-            {
-                return i.Convert(obj, i.TargetType, target);
-            }
-        }
+        Type* leftType = left->GetType();
+        Type* rightType = right != nullptr ? right->GetType() : nullptr;
+
+        auto plan = leftType->GetComparePlan(rightType);
+        if (plan.comparer == ComparePlan::NoComparer)
+            return CompareResult::Failed;
+
+        if (plan.swapped)
+            return rightType->m_objectComparers.Get()[plan.comparer].Compare(right, left);
+        return leftType->m_objectComparers.Get()[plan.comparer].Compare(left, right);
+    }
 
-        if (sourceType->IsEnum() && targetType->HasFlag(TypeFlags::Integral))
+    // 根据名称查找类型
+    static Type* Find(std::string_view name)
+    {
+        // 冻结后创建的类型不在冻结的名称表中，未命中时继续查找普通索引
+        if (auto frozen = GetFrozenRegistry().Load())
         {
-            ObjectPtr underlyingObj = nullptr;
-            return Convert(obj, sourceType->GetUnderlyingType(), underlyingObj) && Convert(underlyingObj, targetType, target);
+            auto slot = FindFrozenSlot(frozen->typeSlots, name);
+            if (slot != nullptr)
+                return FromId(slot->first);
         }
 
-        if (sourceType->HasFlag(TypeFlags::Integral) && targetType->IsEnum())
+        ReadGuard guard;
+        auto index = GetNameIndex().Load();
+        if (index == nullptr)
+            return nullptr;
+
+        size_t hash = std::hash<std::string_view>()(name);
+        for (auto node = index->buckets[hash & index->mask].load(std::memory_order_acquire); node != nullptr; node = node->next)
         {
-            ObjectPtr underlyingObj = nullptr;
-            return Convert(obj, sourceType->GetUnderlyingType(), underlyingObj) && Convert(underlyingObj, targetType, target);
+            // 改名后旧名称字符串可能已释放，先确认节点有效再比较
+            if (node->hash == hash && node->IsValid() && *node->name == name)
+                return node->type;
         }
+        return nullptr;
+    }
 
-        return false;
+    // 根据编号查找类型
+    static Type* FromId(TypeId id)
+    {
+        auto types = GetTypeTable().Get();
+        return id < types.size() ? types[id] : nullptr;
     }
 
-    // 比较 left 和 right
-    static bool IsComparable(Type* leftType, Type* rightType)
+    // 已创建的类型数量，编号范围为 [0, GetTypeCount())
+    static size_t GetTypeCount()
     {
-        if (leftType == nullptr)
+        return GetTypeTable().size();
+    }
+
+    // 带有特性 id 的全部类型和成员（构造函数、方法、属性），按注册顺序
+    static std::span<const AttributeTarget> GetAttributeTargets(size_t id)
+    {
+        auto index = GetAttributeIndex().Load();
+        if (index == nullptr)
+            return {};
+
+        auto it = index->targets.find(id);
+        return it != index->targets.end() ? it->second->Get() : std::span<const AttributeTarget>();
+    }
+
+    // 冻结：把全部类型的名称和展开后的成员索引复制到一块连续的只读内存中，之后的查询只访问这块内存
+    // 冻结后新建的类型使用普通索引；给冻结的类型注册方法或属性、改名、新建同名类型须先调用 Unfreeze()，完成后再次冻结
+    static void Freeze()
+    {
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+
+        auto types = GetTypeTable().Get();
+        std::vector<const MemberTable*> tables;
+        size_t methodCount = 0;
+        size_t propertyCount = 0;
+        size_t slotCount = GetHashSlotCount(types.size());
+        size_t charCount = 0;
+        for (auto type : types)
         {
-            if (rightType == nullptr)
-                return true;
-            else
-                return Type::IsComparable(rightType, leftType);
+            // 已释放的类型在编号表中为 nullptr，对应的 FrozenMembers 留空
+            if (type == nullptr)
+            {
+                tables.push_back(nullptr);
+                continue;
+            }
+
+            const auto& table = type->GetMemberTable();
+            tables.push_back(&table);
+            methodCount += table.allMethods.size();
+            propertyCount += table.allProperties.size();
+            slotCount += GetHashSlotCount(table.methodRanges.size()) + GetHashSlotCount(table.properties.size());
+            charCount += type->GetName().size();
+            for (auto& [name, range] : table.methodRanges)
+                charCount += name.size();
+            for (auto& [name, property] : table.properties)
+                charCount += name.size();
         }
 
-        for (auto&& i : leftType->m_objectComparers)
+        // 除字符串池外的元素都按 8 字节对齐，字符串池放在末尾
+        size_t size = sizeof(FrozenMembers) * types.size() + sizeof(FrozenSlot) * slotCount + sizeof(MethodInfo*) * methodCount * 2 + sizeof(PropertyInfo*) * propertyCount + charCount;
+        auto frozen = std::make_unique<FrozenRegistry>();
+        frozen->arena = std::make_unique<std::byte[]>(size);
+        std::byte* cursor = frozen->arena.get();
+        char* pool = reinterpret_cast<char*>(cursor + size - charCount);
+
+        std::unordered_map<std::string_view, std::string_view> strings;
+        auto intern = [&](std::string_view str)
         {
-            if ((i.TargetType == nullptr && rightType == nullptr) || (i.TargetType != nullptr && rightType != nullptr && rightType->IsAssignableTo(i.TargetType)))
+            auto [it, inserted] = strings.try_emplace(str);
+            if (inserted)
             {
-                return true;
+                std::copy(str.begin(), str.end(), pool);
+                it->second = std::string_view(pool, str.size());
+                pool += str.size();
             }
-        }
+            return it->second;
+        };
 
-        if (rightType != nullptr)
+        auto members = FrozenAllocate<FrozenMembers>(cursor, types.size());
+        for (size_t i = 0; i < types.size(); i++)
         {
-            for (auto&& i : rightType->m_objectComparers)
+            if (tables[i] == nullptr)
+                continue;
+
+            const auto& table = *tables[i];
+            auto& member = members[i];
+
+            auto allMethods = FrozenAllocate<MethodInfo*>(cursor, table.allMethods.size());
+            std::copy(table.allMethods.begin(), table.allMethods.end(), allMethods.begin());
+            member.allMethods = allMethods;
+
+            auto allProperties = FrozenAllocate<PropertyInfo*>(cursor, table.allProperties.size());
+            std::copy(table.allProperties.begin(), table.allProperties.end(), allProperties.begin());
+            member.allProperties = allProperties;
+
+            auto methods = FrozenAllocate<MethodInfo*>(cursor, table.methods.size());
+            std::copy(table.methods.begin(), table.methods.end(), methods.begin());
+            member.methods = methods;
+
+            auto methodSlots = FrozenAllocate<FrozenSlot>(cursor, GetHashSlotCount(table.methodRanges.size()));
+            for (auto& [name, range] : table.methodRanges)
+                InsertFrozenSlot(methodSlots, {intern(name), range.first, range.second});
+            member.methodSlots = methodSlots;
+
+            // 派生类的同名属性在前，只保留第一个
+            auto propertySlots = FrozenAllocate<FrozenSlot>(cursor, GetHashSlotCount(table.properties.size()));
+            for (uint32_t j = 0; j < table.allProperties.size(); j++)
             {
-                if (i.TargetType != nullptr && leftType->IsAssignableTo(i.TargetType))
-                {
-                    return true;
-                }
+                const auto& name = table.allProperties[j]->GetName();
+                if (FindFrozenSlot(propertySlots, name) == nullptr)
+                    InsertFrozenSlot(propertySlots, {intern(name), j, 1});
             }
+            member.propertySlots = propertySlots;
         }
+        frozen->types = members;
 
-        return false;
+        // 同名时后创建的类型优先
+        auto typeSlots = FrozenAllocate<FrozenSlot>(cursor, GetHashSlotCount(types.size()));
+        for (size_t i = types.size(); i-- > 0;)
+        {
+            if (types[i] == nullptr)
+                continue;
+
+            const auto& name = types[i]->GetName();
+            if (FindFrozenSlot(typeSlots, name) == nullptr)
+                InsertFrozenSlot(typeSlots, {intern(name), (uint32_t)i, 1});
+        }
+        frozen->typeSlots = typeSlots;
+
+        GetFrozenRegistry().Publish(frozen.release());
     }
 
-    static CompareResult Compare(const ObjectPtr& left, const ObjectPtr& right)
+    static bool IsFrozen()
     {
-        if (left == nullptr)
-        {
-            if (right == nullptr)
-                return CompareResult::Equals;
-            else
-                return Type::Compare(right, left);
-        }
+        return GetFrozenRegistry().Load() != nullptr;
+    }
 
-        Type* leftType = left->GetRttiType();
-        Type* rightType = right != nullptr ? right->GetRttiType() : nullptr;
-        for (auto&& i : leftType->m_objectComparers)
-        {
-            if ((i.TargetType == nullptr && rightType == nullptr) || (i.TargetType != nullptr && rightType != nullptr && rightType->IsAssignableTo(i.TargetType)))
-            {
-                return i.Compare(left, right);
-            }
-        }
+    // 解除冻结，查询回到普通索引
+    static void Unfreeze()
+    {
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+        GetFrozenRegistry().Publish(nullptr);
+    }
+
+    // 释放 arena 中的全部元数据：先从注册表中移除其中的类型、成员以及指向这些类型的转换器和比较器，再整体释放
+    // 调用前须保证没有其他线程正在进行反射查询，之后也不能再对其中的类型调用 type_of<T>()
+    // 被替换下来的旧快照也在此时释放
+    // 其他 arena 中的类型不能继承自被释放的类型
+    static void Release(Arena& arena)
+    {
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+
+        // 冻结的索引引用了全部成员，直接丢弃
+        GetFrozenRegistry().Publish(nullptr);
 
-        if (right != nullptr)
+        Type* prev = nullptr;
+        for (Type* cur = header.load(std::memory_order_relaxed); cur != nullptr; cur = cur->next)
         {
-            for (auto&& i : rightType->m_objectComparers)
+            if (arena.Owns(cur))
             {
-                if (i.TargetType != nullptr && leftType->IsAssignableTo(i.TargetType))
-                {
-                    return i.Compare(right, left);
-                }
+                if (prev != nullptr)
+                    prev->next = cur->next;
+                else
+                    header.store(cur->next, std::memory_order_release);
+
+                // 编号不复用，FromId 对已释放的编号返回 nullptr
+                GetTypeTable().Set(cur->m_id, nullptr);
+                continue;
             }
+
+            auto owned = [&](const void* ptr) { return arena.Owns(ptr); };
+            cur->m_constructors.RemoveIf(owned);
+            cur->m_methods.RemoveIf(owned);
+            cur->m_properties.RemoveIf(owned);
+            cur->m_memberVersion.fetch_add(1, std::memory_order_acq_rel);
+            cur->m_typeConvertors.RemoveIf([&](const TypeConvertor& convertor) { return convertor.Owner == &arena || arena.Owns(convertor.TargetType); });
+            cur->m_objectComparers.RemoveIf([&](const ObjectComparer& comparer) { return comparer.Owner == &arena || arena.Owns(comparer.TargetType); });
+            prev = cur;
         }
 
-        return CompareResult::Failed;
+        RebuildNameIndex(GetNameIndex().Load() != nullptr ? GetNameIndex().Load()->mask + 1 : 64, [&](const NameNode& node) { return !arena.Owns(node.type) && node.IsValid(); });
+        UnindexAttributes([&](const AttributeTarget& target) { return arena.Owns(target.Target); });
+        version.fetch_add(1, std::memory_order_acq_rel);
+
+        arena.Clear();
+        ReclaimRetired();
     }
 
-    // 根据名称查找类型
-    static Type* Find(const std::string& name)
+    // 遍历调用时已发布的类型，回调中可以继续注册
+    static void ForEach(const std::function<void(Type*)>& callback)
     {
-        Type* cur = header;
+        Type* cur = header.load(std::memory_order_acquire);
         while (cur != nullptr)
         {
-            if (name == cur->GetName())
-                return cur;
+            callback(cur);
             cur = cur->next;
         }
-        return nullptr;
     }
 
-    static void ForEach(const std::function<void(Type*)>& callback)
+private:
+    // 名称索引的节点，发布后不再修改；类型改名后，指向旧名称的节点失效
+    struct NameNode
     {
-        Type* cur = header;
-        while (cur != nullptr)
+        size_t hash;
+        const std::string* name;
+        Type* type;
+        NameNode* next;
+
+        bool IsValid() const { return type->m_name.Load() == name; }
+    };
+
+    // 名称 --> 类型，链地址法，新节点插在链表头部，同名时后创建（或后改名）的类型优先
+    struct NameIndex
+    {
+        explicit NameIndex(size_t bucketCount)
+            : mask(bucketCount - 1)
+            , buckets(std::make_unique<std::atomic<NameNode*>[]>(bucketCount))
         {
-            callback(cur);
-            cur = cur->next;
         }
+
+        void Insert(const std::string* name, Type* type)
+        {
+            size_t hash = std::hash<std::string_view>()(*name);
+            auto& bucket = buckets[hash & mask];
+            auto node = nodes.emplace_back(std::make_unique<NameNode>(NameNode{hash, name, type, bucket.load(std::memory_order_relaxed)})).get();
+            bucket.store(node, std::memory_order_release);
+        }
+
+        size_t mask;
+        std::unique_ptr<std::atomic<NameNode*>[]> buckets;
+        std::vector<std::unique_ptr<NameNode>> nodes; // 按插入顺序，只有写入方访问
+    };
+
+    static Published<NameIndex>& GetNameIndex()
+    {
+        static Published<NameIndex> index;
+        return index;
+    }
+
+    // 需持有注册表写锁
+    static void IndexName(Type* type)
+    {
+        auto& published = GetNameIndex();
+        auto index = published.Load();
+        if (index == nullptr || index->nodes.size() > index->mask)
+            index = RebuildNameIndex(index != nullptr ? (index->mask + 1) * 2 : 64, [](const NameNode& node) { return node.IsValid(); });
+
+        index->Insert(type->m_name.Load(), type);
+    }
+
+    // 只迁移 keep 返回 true 的节点，按插入顺序重新插入以保持同名时的优先级
+    template <typename Pred>
+    static NameIndex* RebuildNameIndex(size_t bucketCount, Pred keep)
+    {
+        auto& published = GetNameIndex();
+        auto index = published.Load();
+        auto newIndex = new NameIndex(bucketCount);
+        if (index != nullptr)
+        {
+            for (auto& node : index->nodes)
+            {
+                if (keep(*node))
+                    newIndex->Insert(node->name, node->type);
+            }
+        }
+        published.PublishByEpoch(newIndex);
+        return newIndex;
+    }
+
+    static ConcurrentArray<Type*>& GetTypeTable()
+    {
+        static ConcurrentArray<Type*> types;
+        return types;
+    }
+
+    void SetName(const std::string& name)
+    {
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+        if (GetName() == name)
+            return;
+
+        // 旧名称仍被其他类型使用时，这些类型在索引中的节点仍然有效
+        // 冻结的类型改名，或改成与冻结类型相同的名称时，冻结的名称表不再准确
+        auto frozen = GetFrozenRegistry().Load();
+        bool modified = frozen != nullptr && (GetFrozenMembers() != nullptr || FindFrozenSlot(frozen->typeSlots, name) != nullptr);
+
+        m_name.Publish(new std::string(name));
+        IndexName(this);
+        if (modified)
+            OnFrozenModified();
+    }
+
+    // 特性 id --> 带有该特性的类型和成员
+    // 新的特性 id 出现或移除条目时复制并重新发布整张表，各列表只追加，由新旧快照共享
+    struct AttributeIndex
+    {
+        std::unordered_map<size_t, std::shared_ptr<ConcurrentArray<AttributeTarget>>> targets;
+    };
+
+    static Published<AttributeIndex>& GetAttributeIndex()
+    {
+        static Published<AttributeIndex> index;
+        return index;
+    }
+
+    // 需持有注册表写锁
+    static void IndexAttributes(AttributeTargetKind kind, Attributable* target)
+    {
+        for (auto& attribute : target->GetAttributes())
+        {
+            auto index = GetAttributeIndex().Load();
+            std::shared_ptr<ConcurrentArray<AttributeTarget>> targets;
+            if (index != nullptr)
+            {
+                auto it = index->targets.find(attribute.Id);
+                if (it != index->targets.end())
+                    targets = it->second;
+            }
+
+            if (targets == nullptr)
+            {
+                auto newIndex = index != nullptr ? new AttributeIndex(*index) : new AttributeIndex();
+                targets = std::make_shared<ConcurrentArray<AttributeTarget>>();
+                newIndex->targets.emplace(attribute.Id, targets);
+                GetAttributeIndex().Publish(newIndex);
+            }
+
+            targets->Add({kind, target});
+        }
+    }
+
+    // 需持有注册表写锁；含有被移除条目的列表重建为新列表，旧列表随旧快照保留
+    template <typename Pred>
+    static void UnindexAttributes(Pred remove)
+    {
+        auto index = GetAttributeIndex().Load();
+        if (index == nullptr)
+            return;
+
+        auto newIndex = new AttributeIndex();
+        for (auto& [id, targets] : index->targets)
+        {
+            auto items = targets->Get();
+            if (std::none_of(items.begin(), items.end(), remove))
+            {
+                newIndex->targets.emplace(id, targets);
+                continue;
+            }
+
+            auto remaining = std::make_shared<ConcurrentArray<AttributeTarget>>();
+            for (auto& item : items)
+            {
+                if (!remove(item))
+                    remaining->Add(item);
+            }
+            newIndex->targets.emplace(id, remaining);
+        }
+        GetAttributeIndex().Publish(newIndex);
+    }
+
+    // 替换类型的特性，同时更新特性索引
+    void SetAttributes(const std::map<size_t, std::any>& attributes)
+    {
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+        if (!GetAttributes().empty())
+            UnindexAttributes([this](const AttributeTarget& target) { return target.Target == this; });
+
+        Attributable::SetAttributes(attributes);
+        IndexAttributes(AttributeTargetKind::Type, this);
+    }
+
+    // 冻结后的查询结构，均指向 FrozenRegistry::arena
+    struct FrozenSlot
+    {
+        std::string_view name; // 指向字符串池
+        uint32_t first = 0;
+        uint32_t count = 0; // 0 表示空槽
+    };
+
+    struct FrozenMembers
+    {
+        std::span<MethodInfo* const> allMethods;
+        std::span<PropertyInfo* const> allProperties;
+        std::span<MethodInfo* const> methods; // 同名方法连续存放
+        std::span<const FrozenSlot> methodSlots; // [first, first + count) 为 methods 下标
+        std::span<const FrozenSlot> propertySlots; // first 为 allProperties 下标
+    };
+
+    struct FrozenRegistry
+    {
+        std::unique_ptr<std::byte[]> arena;
+        std::span<const FrozenMembers> types; // 按类型编号索引
+        std::span<const FrozenSlot> typeSlots; // first 为类型编号
+    };
+
+    static Published<FrozenRegistry>& GetFrozenRegistry()
+    {
+        static Published<FrozenRegistry> frozen;
+        return frozen;
+    }
+
+    // 冻结时已存在的类型才有冻结的成员索引
+    const FrozenMembers* GetFrozenMembers() const
+    {
+        auto frozen = GetFrozenRegistry().Load();
+        return frozen != nullptr && m_id < frozen->types.size() ? &frozen->types[m_id] : nullptr;
+    }
+
+    // 冻结后未先调用 Unfreeze() 就修改了冻结的元数据：调试版本断言失败，发布版本输出错误并回退到普通索引
+    static void OnFrozenModified()
+    {
+        if (GetFrozenRegistry().Load() == nullptr)
+            return;
+
+        RTTI_ERROR("registry modified after Type::Freeze(), call Type::Unfreeze() before registering");
+        assert(false && "registry modified after Type::Freeze(), call Type::Unfreeze() before registering");
+        GetFrozenRegistry().Publish(nullptr);
+    }
+
+    // 元素类型都可平凡析构，随 arena 一起释放
+    template <typename T>
+    static std::span<T> FrozenAllocate(std::byte*& cursor, size_t count)
+    {
+        auto items = reinterpret_cast<T*>(cursor);
+        std::uninitialized_value_construct_n(items, count);
+        cursor += sizeof(T) * count;
+        return std::span<T>(items, count);
+    }
+
+    static const FrozenSlot* FindFrozenSlot(std::span<const FrozenSlot> slots, std::string_view name)
+    {
+        size_t mask = slots.size() - 1;
+        for (size_t i = HashString(name) & mask;; i = (i + 1) & mask)
+        {
+            if (slots[i].count == 0)
+                return nullptr;
+            if (slots[i].name == name)
+                return &slots[i];
+        }
+    }
+
+    static void InsertFrozenSlot(std::span<FrozenSlot> slots, const FrozenSlot& slot)
+    {
+        size_t mask = slots.size() - 1;
+        size_t i = HashString(slot.name) & mask;
+        while (slots[i].count != 0)
+            i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+
+    // 展开继承链后的成员索引，派生类的同名成员在前
+    struct MemberTable
+    {
+        size_t version = 0; // 构建时继承链上各类型的成员版本之和
+        std::vector<MethodInfo*> allMethods; // 按继承链顺序，派生类在前
+        std::vector<PropertyInfo*> allProperties; // 按继承链顺序，派生类在前
+        std::vector<MethodInfo*> methods; // 同名方法连续存放
+        std::unordered_map<std::string_view, std::pair<uint32_t, uint32_t>> methodRanges;
+        std::unordered_map<std::string_view, PropertyInfo*> properties;
+    };
+
+    // 继承链上的成员变化后重建并发布新的快照，旧快照保留给仍在访问的读者
+    // 只有自身或基类型注册了成员才重建，注册其他类型不影响
+    const MemberTable& GetMemberTable() const
+    {
+        size_t currentVersion = 0;
+        for (auto type : m_ancestors)
+            currentVersion += type->m_memberVersion.load(std::memory_order_acquire);
+
+        auto table = m_memberTable.Load();
+        if (table != nullptr && table->version == currentVersion)
+            return *table;
+
+        table = BuildMemberTable(currentVersion).release();
+        m_memberTable.Publish(table);
+        return *table;
+    }
+
+    std::unique_ptr<MemberTable> BuildMemberTable(size_t currentVersion) const
+    {
+        auto table = std::make_unique<MemberTable>();
+        table->version = currentVersion;
+
+        for (auto curType = this; curType != nullptr; curType = curType->GetBaseType())
+        {
+            auto methods = curType->m_methods.Get();
+            auto properties = curType->m_properties.Get();
+
+            table->allMethods.insert(table->allMethods.end(), methods.begin(), methods.end());
+            table->allProperties.insert(table->allProperties.end(), properties.begin(), properties.end());
+
+            for (auto m : methods)
+                table->methodRanges[m->GetName()].second++;
+
+            for (auto p : properties)
+                table->properties.try_emplace(p->GetName(), p);
+        }
+
+        uint32_t offset = 0;
+        for (auto& [name, range] : table->methodRanges)
+        {
+            range.first = offset;
+            offset += range.second;
+            range.second = 0;
+        }
+
+        table->methods.resize(offset);
+        for (auto m : table->allMethods)
+        {
+            auto& range = table->methodRanges[m->GetName()];
+            table->methods[range.first + range.second++] = m;
+        }
+
+        return table;
+    }
+
+    // 名称为 name 的全部方法（含基类），派生类的在前
+    std::span<MethodInfo* const> FindMethods(std::string_view name) const
+    {
+        if (auto frozen = GetFrozenMembers())
+        {
+            auto slot = FindFrozenSlot(frozen->methodSlots, name);
+            if (slot == nullptr)
+                return {};
+            return frozen->methods.subspan(slot->first, slot->count);
+        }
+
+        const auto& table = GetMemberTable();
+        auto it = table.methodRanges.find(name);
+        if (it == table.methodRanges.end())
+            return {};
+        return std::span<MethodInfo* const>(table.methods.data() + it->second.first, it->second.second);
+    }
+
+    // 按注册顺序查找第一个能接受 args 的构造函数
+    ConstructorInfo* ResolveConstructor(std::span<const ObjectPtr> args) const
+    {
+        for (auto ctor : m_constructors.Get())
+        {
+            if (ctor->GetParameters().size() == args.size())
+            {
+                bool ok = true;
+                for (size_t j = 0; j < args.size(); j++)
+                {
+                    auto pt = ctor->GetParameters()[j];
+                    if (pt.ParameterType->IsValueType())
+                    {
+                        if (args[j] == nullptr || args[j]->GetType() != pt.ParameterType)
+                        {
+                            ok = false;
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (args[j] != nullptr && !args[j]->GetType()->CanConvertTo(pt.ParameterType))
+                        {
+                            ok = false;
+                            break;
+                        }
+                    }
+                }
+                if (ok)
+                {
+                    return ctor;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    // 构造函数的选择只取决于实参的运行时类型，按实参类型序列缓存
+    ConstructorInfo* FindConstructor(std::span<const ObjectPtr> args) const
+    {
+        auto argTypeId = [](const ObjectPtr& arg) -> TypeId
+        {
+            return arg != nullptr ? arg->GetType()->GetId() : ~TypeId(0);
+        };
+
+        size_t key = args.size();
+        for (auto&& arg : args)
+            hash_combine(key, argTypeId(arg));
+
+        ReadGuard guard;
+        auto currentVersion = version.load(std::memory_order_acquire);
+        auto cache = m_constructorCache.Load();
+        if (cache != nullptr && cache->version == currentVersion)
+        {
+            for (auto entry = cache->Bucket(key).load(std::memory_order_acquire); entry != nullptr; entry = entry->next)
+            {
+                const auto& argTypes = entry->argTypes;
+                if (entry->key == key && argTypes.size() == args.size() && std::equal(argTypes.begin(), argTypes.end(), args.begin(), [&](TypeId id, const ObjectPtr& arg) { return id == argTypeId(arg); }))
+                    return entry->constructor;
+            }
+        }
+
+        auto ctor = ResolveConstructor(args);
+
+        // 版本变化后才整体替换缓存，加锁避免并发替换时互相覆盖
+        if (cache == nullptr || cache->version != currentVersion)
+        {
+            std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+            if (version.load(std::memory_order_acquire) != currentVersion)
+                return ctor;
+
+            cache = m_constructorCache.Load();
+            if (cache == nullptr || cache->version != currentVersion)
+            {
+                cache = new ConstructorCache(currentVersion);
+                m_constructorCache.PublishByEpoch(cache);
+            }
+        }
+
+        auto entry = new ConstructorCacheEntry{key, {}, ctor, nullptr};
+        for (auto&& arg : args)
+            entry->argTypes.push_back(argTypeId(arg));
+
+        // 无锁插入到桶的头部，并发插入相同的实参序列只会多出一个重复条目
+        auto& bucket = cache->Bucket(key);
+        entry->next = bucket.load(std::memory_order_relaxed);
+        while (!bucket.compare_exchange_weak(entry->next, entry, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        return ctor;
+    }
+
+    enum class ConvertKind : uint8_t
+    {
+        Unresolved,
+        None,
+        Assign,
+        PointerToVoid,
+        Constructor,
+        Convertor,
+        EnumToIntegral,
+        IntegralToEnum,
+    };
+
+    // 当前类型转换为某一目标类型时选用的规则
+    struct ConvertPlan
+    {
+        ConvertKind kind = ConvertKind::Unresolved;
+        uint32_t convertor = 0; // m_typeConvertors 下标
+    };
+
+    // 按 Convert 的规则顺序查找第一条适用的规则
+    ConvertPlan ResolveConvertPlan(Type* targetType, bool skipConstructor = false) const
+    {
+        Type* sourceType = const_cast<Type*>(this);
+
+        if (targetType->IsAssignableFrom(sourceType))
+            return {ConvertKind::Assign};
+
+        if (IsPointer() && targetType == type_of<void*>())
+            return {ConvertKind::PointerToVoid};
+
+        if (!skipConstructor)
+        {
+            for (auto&& i : targetType->m_constructors.Get())
+            {
+                if (i->GetParameters().size() == 1 && i->GetParameters()[0].ParameterType->IsAssignableFrom(sourceType))
+                    return {ConvertKind::Constructor};
+            }
+        }
+
+        auto convertors = m_typeConvertors.Get();
+        for (uint32_t i = 0; i < convertors.size(); i++)
+        {
+            if (convertors[i].TargetType->IsAssignableTo(targetType))
+                return {ConvertKind::Convertor, i};
+        }
+
+        if (IsEnum() && targetType->HasFlag(TypeFlags::Integral))
+            return {ConvertKind::EnumToIntegral};
+
+        if (HasFlag(TypeFlags::Integral) && targetType->IsEnum())
+            return {ConvertKind::IntegralToEnum};
+
+        return {ConvertKind::None};
+    }
+
+    // 缓存 (当前类型, targetType) 的转换规则，包括无法转换的结果，按 targetType 的编号索引
+    ConvertPlan GetConvertPlan(Type* targetType) const
+    {
+        auto currentVersion = version.load(std::memory_order_acquire);
+        auto id = targetType->GetId();
+        auto plan = m_convertPlans.Get(id, currentVersion);
+        if (plan.kind != ConvertKind::Unresolved)
+            return plan;
+
+        plan = ResolveConvertPlan(targetType);
+        m_convertPlans.Set(id, currentVersion, plan, GetTypeCount());
+        return plan;
+    }
+
+    bool ApplyConvertPlan(ConvertPlan plan, const ObjectPtr& obj, Type* targetType, ObjectPtr& target) const
+    {
+        switch (plan.kind)
+        {
+            case ConvertKind::Assign:
+                target = obj;
+                return true;
+
+            case ConvertKind::PointerToVoid:
+                target = rtti::Box(rtti::Unbox<void*>(obj));
+                return true;
+
+            case ConvertKind::Constructor:
+                target = targetType->CreateInstance({obj});
+                if (target != nullptr)
+                    return true;
+                // 构造失败时继续尝试后续规则
+                return ApplyConvertPlan(ResolveConvertPlan(targetType, true), obj, targetType, target);
+
+            case ConvertKind::Convertor:
+            {
+                const auto& convertor = m_typeConvertors.Get()[plan.convertor];
+                return convertor.Convert(obj, convertor.TargetType, target);
+            }
+
+            case ConvertKind::EnumToIntegral:
+            {
+                ObjectPtr underlyingObj = nullptr;
+                return Convert(obj, GetUnderlyingType(), underlyingObj) && Convert(underlyingObj, targetType, target);
+            }
+
+            case ConvertKind::IntegralToEnum:
+            {
+                ObjectPtr underlyingObj = nullptr;
+                return Convert(obj, targetType->GetUnderlyingType(), underlyingObj) && Convert(underlyingObj, targetType, target);
+            }
+
+            default:
+                return false;
+        }
+    }
+
+    // 当前类型与某一类型比较时选用的比较器
+    struct ComparePlan
+    {
+        static constexpr uint32_t NoComparer = ~0u;
+
+        uint32_t comparer = NoComparer; // m_objectComparers 下标
+        bool swapped = false; // 比较器来自右侧类型，调用时交换参数
+        bool resolved = false;
+    };
+
+    ComparePlan ResolveComparePlan(Type* rightType) const
+    {
+        auto comparers = m_objectComparers.Get();
+        for (uint32_t i = 0; i < comparers.size(); i++)
+        {
+            auto targetType = comparers[i].TargetType;
+            if ((targetType == nullptr && rightType == nullptr) || (targetType != nullptr && rightType != nullptr && rightType->IsAssignableTo(targetType)))
+                return {i, false, true};
+        }
+
+        if (rightType != nullptr)
+        {
+            auto rightComparers = rightType->m_objectComparers.Get();
+            for (uint32_t i = 0; i < rightComparers.size(); i++)
+            {
+                auto targetType = rightComparers[i].TargetType;
+                if (targetType != nullptr && IsAssignableTo(targetType))
+                    return {i, true, true};
+            }
+        }
+
+        return {ComparePlan::NoComparer, false, true};
+    }
+
+    // 缓存 (当前类型, rightType) 的比较器，包括无法比较的结果，按 rightType 的编号 + 1 索引，0 表示 nullptr
+    ComparePlan GetComparePlan(Type* rightType) const
+    {
+        auto currentVersion = version.load(std::memory_order_acquire);
+        size_t index = rightType != nullptr ? rightType->GetId() + 1 : 0;
+        auto plan = m_comparePlans.Get(index, currentVersion);
+        if (plan.resolved)
+            return plan;
+
+        plan = ResolveComparePlan(rightType);
+        m_comparePlans.Set(index, currentVersion, plan, GetTypeCount() + 1);
+        return plan;
+    }
+
+    // 注册成员：先追加到数组，再递增版本号使缓存失效
+    void AddComparer(ObjectComparer comparer)
+    {
+        if (comparer.Owner == nullptr)
+            comparer.Owner = &GetCurrentArena();
+        m_objectComparers.Add(comparer);
+        version.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    void AddConstructor(ConstructorInfo* constructor)
+    {
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+        IndexAttributes(AttributeTargetKind::Constructor, constructor);
+        m_constructors.Add(constructor);
+        version.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    void AddConvertor(TypeConvertor convertor)
+    {
+        if (convertor.Owner == nullptr)
+            convertor.Owner = &GetCurrentArena();
+        m_typeConvertors.Add(convertor);
+        version.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // 枚举值表，infos / slots 指向 infoStorage / slotStorage 或静态表
+    struct EnumTable
+    {
+        std::span<const EnumInfo> infos;
+        std::span<const uint32_t> slots;
+        bool dense = false;
+        std::vector<EnumInfo> infoStorage;
+        std::vector<uint32_t> slotStorage;
+    };
+
+    // 手动注册的枚举值，同名时覆盖
+    void AddEnumValue(const std::string& name, int64_t value)
+    {
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+
+        // 在已有的（可能是静态的）枚举值表的副本上修改
+        auto table = std::make_unique<EnumTable>();
+        auto current = GetEnumInfos();
+        auto& infos = table->infoStorage;
+        infos.assign(current.begin(), current.end());
+
+        auto it = std::find_if(infos.begin(), infos.end(), [&](const EnumInfo& info) { return info.Name == name; });
+        if (it != infos.end())
+            it->Value = value;
+        else
+            infos.push_back({value, m_enumNames.emplace_back(name)});
+
+        std::sort(infos.begin(), infos.end(), [](const EnumInfo& a, const EnumInfo& b) { return a.Value < b.Value || (a.Value == b.Value && a.Name < b.Name); });
+
+        auto& slots = table->slotStorage;
+        slots.assign(GetHashSlotCount(infos.size()), 0);
+        BuildEnumNameSlots(infos, slots);
+
+        table->infos = infos;
+        table->slots = slots;
+        PublishEnumTable(table.release());
+    }
+
+    void SetEnumTable(std::span<const EnumInfo> infos, std::span<const uint32_t> slots)
+    {
+        auto table = new EnumTable();
+        table->infos = infos;
+        table->slots = slots;
+        PublishEnumTable(table);
+    }
+
+    void PublishEnumTable(EnumTable* table)
+    {
+        // 值连续时按 value - 最小值 直接索引
+        table->dense = true;
+        for (size_t i = 1; i < table->infos.size(); i++)
+        {
+            if (table->infos[i].Value != table->infos[i - 1].Value + 1)
+            {
+                table->dense = false;
+                break;
+            }
+        }
+
+        m_enumTable.Publish(table);
+    }
+
+    void AddMethod(MethodInfo* method)
+    {
+        // 加锁使追加与解除冻结不会和 Freeze() 交错
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+        IndexAttributes(AttributeTargetKind::Method, method);
+        m_methods.Add(method);
+        m_memberVersion.fetch_add(1, std::memory_order_acq_rel);
+        // 冻结后新建的类型不在冻结表中，可以继续注册成员
+        if (GetFrozenMembers() != nullptr)
+            OnFrozenModified();
+    }
+
+    void AddProperty(PropertyInfo* property)
+    {
+        std::lock_guard<std::recursive_mutex> lock(GetRegistryMutex());
+        IndexAttributes(AttributeTargetKind::Property, property);
+        m_properties.Add(property);
+        m_memberVersion.fetch_add(1, std::memory_order_acq_rel);
+        if (GetFrozenMembers() != nullptr)
+            OnFrozenModified();
     }
 
 protected:
-    std::string m_name;
+    // 成员数组只追加，注册在写锁内进行，查询无锁
+    Published<std::string> m_name;
     uint32_t m_size;
     TypeFlags m_flags;
     Type* m_baseType;
     Type* m_underlyingType = nullptr;
-    std::vector<ConstructorInfo*> m_constructors;
-    std::vector<MethodInfo*> m_methods;
-    std::vector<PropertyInfo*> m_properties;
-    std::vector<TypeConvertor> m_typeConvertors;
-    std::vector<ObjectComparer> m_objectComparers;
-    std::map<std::string, ObjectPtr> m_enumValues;
-    Type* next;
-
-    static Type* header;
+    ConcurrentArray<ConstructorInfo*> m_constructors;
+    ConcurrentArray<MethodInfo*> m_methods;
+    ConcurrentArray<PropertyInfo*> m_properties;
+    ConcurrentArray<TypeConvertor> m_typeConvertors;
+    ConcurrentArray<ObjectComparer> m_objectComparers;
+
+    Published<EnumTable> m_enumTable;
+    std::deque<std::string> m_enumNames; // deque 保证元素地址不变，只在写锁内追加
+    ObjectPtr (*m_enumBox)(int64_t value) = nullptr;
+    int64_t (*m_enumUnbox)(const ObjectPtr& obj) = nullptr;
+    Type* next = nullptr;
+    TypeId m_id;
+    mutable Published<MemberTable> m_memberTable;
+    std::atomic<size_t> m_memberVersion = 0; // 注册方法或属性时递增
+
+    // 从根类型到当前类型的继承链，基类型在创建时确定，之后不再变化
+    std::vector<Type*> m_ancestors;
+
+    struct ConstructorCacheEntry
+    {
+        size_t key;
+        std::vector<TypeId> argTypes; // nullptr 实参记为 ~TypeId(0)
+        ConstructorInfo* constructor;
+        ConstructorCacheEntry* next;
+    };
+
+    // 同一版本内只追加条目，不复制已有内容
+    struct ConstructorCache
+    {
+        explicit ConstructorCache(size_t version)
+            : version(version)
+        {
+        }
+
+        ~ConstructorCache()
+        {
+            for (auto& bucket : buckets)
+            {
+                for (auto entry = bucket.load(std::memory_order_relaxed); entry != nullptr;)
+                    delete std::exchange(entry, entry->next);
+            }
+        }
+
+        std::atomic<ConstructorCacheEntry*>& Bucket(size_t key)
+        {
+            return buckets[key % buckets.size()];
+        }
+
+        size_t version;
+        std::array<std::atomic<ConstructorCacheEntry*>, 16> buckets{};
+    };
+
+    mutable Published<ConstructorCache> m_constructorCache;
+    mutable IdCache<ConvertPlan> m_convertPlans;
+    mutable IdCache<ComparePlan> m_comparePlans;
+
+    static std::atomic<Type*> header;
+
+    // 构造函数、转换器或比较器变化时递增，用于使转换 / 比较规则和构造函数缓存失效
+    static std::atomic<size_t> version;
 };
 
-inline Type* Type::header = nullptr;
+inline std::atomic<Type*> Type::header = nullptr;
+inline std::atomic<size_t> Type::version = 0;
+
+// 释放全局 arena 中的元数据和全部旧快照，各模块的 arena 应先通过 Type::Release() 释放
+// 调用后不能再使用反射
+inline void Shutdown()
+{
+    Type::Release(GetDefaultArena());
+}
 
 inline Type* NewType(const std::string& name, size_t size, TypeFlags flags, Type* underlyingType, Type* base)
 {
-    return new Type(name, size, flags, underlyingType, base, {});
+    return GetCurrentArena().New<Type>(name, size, flags, underlyingType, base, std::map<size_t, std::any>());
 }
 
 // 将 obj 转换为目标类型，只支持单次转换
@@ -709,7 +1641,7 @@ inline auto cast(const From& from, bool* pOK)
             //}
             // else
             {
-                bool convertible = std::is_same_v<TFrom, TTo> || std::is_convertible_v<TFrom, TTo> || from == nullptr || from->GetRttiType()->template IsAssignableTo<TTo>();
+                bool convertible = std::is_same_v<TFrom, TTo> || std::is_convertible_v<TFrom, TTo> || from == nullptr || from->GetType()->template IsAssignableTo<TTo>();
 
                 if constexpr (std::is_same_v<TFrom*, From>)
                 {
@@ -755,10 +1687,10 @@ inline auto cast(const From& from, bool* pOK)
 
             if (from != nullptr)
             {
-                if (from->GetRttiType() == type_of<TTo>() || from->GetRttiType() == type_of<std::remove_pointer_t<TTo>>())
+                if (from->GetType() == type_of<TTo>() || from->GetType() == type_of<std::remove_pointer_t<TTo>>())
                     RETURN(Unbox<TTo>(from), true);
 
-                if (from->GetRttiType()->IsPointer() && std::is_same_v<TTo, void*>)
+                if (from->GetType()->IsPointer() && std::is_same_v<TTo, void*>)
                     RETURN(Unbox<TTo>(from), true);
 
                 ObjectPtr target = nullptr;
@@ -766,7 +1698,7 @@ inline auto cast(const From& from, bool* pOK)
                     RETURN(Unbox<TTo>(target), true);
             }
 
-            RTTI_ERROR((std::string("conversion of ") + (from == nullptr ? std::string("nullptr") : from->GetRttiType()->GetName()) + std::string(" to ") + type_of<TTo>()->GetName() + std::string(" is not allowed ")).c_str());
+            RTTI_ERROR((std::string("conversion of ") + (from == nullptr ? std::string("nullptr") : from->GetType()->GetName()) + std::string(" to ") + type_of<TTo>()->GetName() + std::string(" is not allowed ")).c_str());
             RETURN(TTo(), false)
         }
     }
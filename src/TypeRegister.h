@@ -30,7 +30,7 @@ template <class T, class... Args>
 inline rtti::ObjectPtr ctor(Args... args)
 {
     if constexpr (rtti::is_object<T>)
-        return Ptr<T>(new T(std::forward<Args>(args)...));
+        return MakePtr<T>(std::forward<Args>(args)...);
     else
         return rtti::Box(T(std::forward<Args>(args)...));
 }
@@ -45,15 +45,15 @@ public:
     static TypeRegister<T> New(const std::map<size_t, std::any>& attributes = {})
     {
         Type* type = type_of<T>();
-        type->m_attributes = attributes;
+        type->SetAttributes(attributes);
 
         TypeRegister<T> reg;
 
         // if constexpr(!is_object<T>)
         //{
         //     if constexpr(std::)
-        //     type->m_constructors.push_back(ConstructorInfo::Register<T>(&ctor<T>));
-        //     type->m_constructors.push_back(ConstructorInfo::Register<T>(&ctor<T, const T&>));
+        //     type->AddConstructor(ConstructorInfo::Register<T>(&ctor<T>));
+        //     type->AddConstructor(ConstructorInfo::Register<T>(&ctor<T, const T&>));
         // }
 
         return reg;
@@ -62,16 +62,16 @@ public:
     static TypeRegister<T> New(const std::string& name, const std::map<size_t, std::any>& attributes = {})
     {
         Type* type = type_of<T>();
-        type->m_name = name;
-        type->m_attributes = attributes;
+        type->SetName(name);
+        type->SetAttributes(attributes);
 
         TypeRegister<T> reg;
 
         // if constexpr(!is_object<T>)
         //{
         //     if constexpr(std::)
-        //     type->m_constructors.push_back(ConstructorInfo::Register<T>(&ctor<T>));
-        //     type->m_constructors.push_back(ConstructorInfo::Register<T>(&ctor<T, const T&>));
+        //     type->AddConstructor(ConstructorInfo::Register<T>(&ctor<T>));
+        //     type->AddConstructor(ConstructorInfo::Register<T>(&ctor<T, const T&>));
         // }
 
         return reg;
@@ -80,60 +80,60 @@ public:
     template <typename... Args>
     TypeRegister<T>& constructor(const std::map<size_t, std::any>& attributes = {})
     {
-        type_of<T>()->m_constructors.push_back(ConstructorInfo::Register<T>(&ctor<T, Args...>, attributes));
+        type_of<T>()->AddConstructor(ConstructorInfo::Register<T>(&ctor<T, Args...>, attributes));
         return *this;
     }
 
     template <typename U>
     TypeRegister<T>& convert()
     {
-        type_of<T>()->m_typeConvertors.push_back({type_of<U>(), [](const ObjectPtr& obj, [[maybe_unused]] Type* targetType, ObjectPtr& target) -> bool
-                                                  {
-                                                      using TU = type_t<U>;
-                                                      if constexpr (is_object<T>)
-                                                      {
-                                                          Ptr<T> tobj = cast<Ptr<T>>(obj);
-                                                          if constexpr (is_object<TU>)
-                                                          {
-                                                              Ptr<TU> uobj = nullptr;
-                                                              if (tobj->template ConvertTo<Ptr<TU>>(uobj))
-                                                              {
-                                                                  target = uobj;
-                                                                  return true;
-                                                              }
-                                                          }
-                                                          else
-                                                          {
-                                                              TU uobj;
-                                                              if (tobj->template ConvertTo<TU>(uobj))
-                                                              {
-                                                                  target = rtti::Box(uobj);
-                                                                  return true;
-                                                              }
-                                                          }
-                                                      }
-                                                      else
-                                                      {
-                                                          if constexpr (is_object<TU>)
-                                                          {
-                                                              target = static_cast<Ptr<TU>>(rtti::Unbox<T>(obj));
-                                                              return true;
-                                                          }
-                                                          else
-                                                          {
-                                                              target = rtti::Box(static_cast<TU>(rtti::Unbox<T>(obj)));
-                                                              return true;
-                                                          }
-                                                      }
-                                                      return false;
-                                                  }});
+        type_of<T>()->AddConvertor({type_of<U>(), [](const ObjectPtr& obj, [[maybe_unused]] Type* targetType, ObjectPtr& target) -> bool
+                                    {
+                                        using TU = type_t<U>;
+                                        if constexpr (is_object<T>)
+                                        {
+                                            Ptr<T> tobj = cast<Ptr<T>>(obj);
+                                            if constexpr (is_object<TU>)
+                                            {
+                                                Ptr<TU> uobj = nullptr;
+                                                if (tobj->template ConvertTo<Ptr<TU>>(uobj))
+                                                {
+                                                    target = uobj;
+                                                    return true;
+                                                }
+                                            }
+                                            else
+                                            {
+                                                TU uobj;
+                                                if (tobj->template ConvertTo<TU>(uobj))
+                                                {
+                                                    target = rtti::Box(uobj);
+                                                    return true;
+                                                }
+                                            }
+                                        }
+                                        else
+                                        {
+                                            if constexpr (is_object<TU>)
+                                            {
+                                                target = static_cast<Ptr<TU>>(rtti::Unbox<T>(obj));
+                                                return true;
+                                            }
+                                            else
+                                            {
+                                                target = rtti::Box(static_cast<TU>(rtti::Unbox<T>(obj)));
+                                                return true;
+                                            }
+                                        }
+                                        return false;
+                                    }});
         return *this;
     }
 
     template <typename U>
     TypeRegister<T>& compare()
     {
-        type_of<T>()->m_objectComparers.push_back({type_of<U>(), &comparer<T, U>});
+        type_of<T>()->AddComparer({type_of<U>(), &comparer<T, U>});
         return *this;
     }
 
@@ -142,7 +142,7 @@ public:
         requires(!std::is_arithmetic_v<U>)
     TypeRegister<T>& property(const std::string& name, R (U::*getter)(), void (U::*setter)(R), const std::map<size_t, std::any>& attributes = {})
     {
-        type_of<T>()->m_properties.push_back(new PropertyInfo(type_of<T>(), name, type_of<R>(), MethodInfo::Register<T, decltype(getter), R>(name, getter), MethodInfo::Register<T, decltype(setter), void, R>(name, setter), attributes));
+        type_of<T>()->AddProperty(GetCurrentArena().New<PropertyInfo>(type_of<T>(), name, type_of<R>(), MethodInfo::Register<T, decltype(getter), R>(name, getter), MethodInfo::Register<T, decltype(setter), void, R>(name, setter), attributes));
         return *this;
     }
 
@@ -151,7 +151,7 @@ public:
         requires(!std::is_arithmetic_v<U>)
     TypeRegister<T>& property(const std::string& name, R (U::*getter)(), const std::map<size_t, std::any>& attributes = {})
     {
-        type_of<T>()->m_properties.push_back(new PropertyInfo(type_of<T>(), name, type_of<R>(), MethodInfo::Register<T, decltype(getter), R>(name, getter), nullptr, attributes));
+        type_of<T>()->AddProperty(GetCurrentArena().New<PropertyInfo>(type_of<T>(), name, type_of<R>(), MethodInfo::Register<T, decltype(getter), R>(name, getter), nullptr, attributes));
         return *this;
     }
 
@@ -160,7 +160,7 @@ public:
         requires(!std::is_arithmetic_v<U>)
     TypeRegister<T>& property(const std::string& name, R (U::*getter)() const, void (U::*setter)(R), const std::map<size_t, std::any>& attributes = {})
     {
-        type_of<T>()->m_properties.push_back(new PropertyInfo(type_of<T>(), name, type_of<R>(), MethodInfo::Register<T, decltype(getter), R>(name, getter), MethodInfo::Register<T, decltype(setter), void, R>(name, setter), attributes));
+        type_of<T>()->AddProperty(GetCurrentArena().New<PropertyInfo>(type_of<T>(), name, type_of<R>(), MethodInfo::Register<T, decltype(getter), R>(name, getter), MethodInfo::Register<T, decltype(setter), void, R>(name, setter), attributes));
         return *this;
     }
 
@@ -169,7 +169,7 @@ public:
         requires(!std::is_arithmetic_v<U>)
     TypeRegister<T>& property(const std::string& name, R (U::*getter)() const, const std::map<size_t, std::any>& attributes = {})
     {
-        type_of<T>()->m_properties.push_back(new PropertyInfo(type_of<T>(), name, type_of<R>(), MethodInfo::Register<T, decltype(getter), R>(name, getter), nullptr, attributes));
+        type_of<T>()->AddProperty(GetCurrentArena().New<PropertyInfo>(type_of<T>(), name, type_of<R>(), MethodInfo::Register<T, decltype(getter), R>(name, getter), nullptr, attributes));
         return *this;
     }
 
@@ -181,11 +181,11 @@ public:
         MethodInfo* getter = MethodInfo::Register<T, decltype(field), R>(name, field);
         if constexpr (READONLY || std::is_const_v<std::remove_reference_t<R>>)
         {
-            type_of<T>()->m_properties.push_back(new PropertyInfo(type_of<T>(), name, type_of<R>(), getter, nullptr, attributes));
+            type_of<T>()->AddProperty(GetCurrentArena().New<PropertyInfo>(type_of<T>(), name, type_of<R>(), getter, nullptr, attributes));
         }
         else
         {
-            type_of<T>()->m_properties.push_back(new PropertyInfo(type_of<T>(), name, type_of<R>(), getter, MethodInfo::Register<T, decltype(field), void, R>(name, field), attributes));
+            type_of<T>()->AddProperty(GetCurrentArena().New<PropertyInfo>(type_of<T>(), name, type_of<R>(), getter, MethodInfo::Register<T, decltype(field), void, R>(name, field), attributes));
         }
         return *this;
     }
@@ -194,7 +194,7 @@ public:
         requires(!std::is_arithmetic_v<U>)
     TypeRegister<T>& method(const std::string& name, R (U::*func)(Args...), const std::map<size_t, std::any>& attributes = {})
     {
-        type_of<T>()->m_methods.push_back(MethodInfo::Register<T, decltype(func), R, Args...>(name, func, attributes));
+        type_of<T>()->AddMethod(MethodInfo::Register<T, decltype(func), R, Args...>(name, func, attributes));
         return *this;
     }
 
@@ -202,7 +202,7 @@ public:
         requires(!std::is_arithmetic_v<U>)
     TypeRegister<T>& method(const std::string& name, R (U::*func)(Args...) const, const std::map<size_t, std::any>& attributes = {})
     {
-        type_of<T>()->m_methods.push_back(MethodInfo::Register<T, decltype(func), R, Args...>(name, func, attributes));
+        type_of<T>()->AddMethod(MethodInfo::Register<T, decltype(func), R, Args...>(name, func, attributes));
         return *this;
     }
 
@@ -210,11 +210,34 @@ public:
     template <typename R, typename... Args>
     TypeRegister<T>& method(const std::string& name, R (*func)(Args...), const std::map<size_t, std::any>& attributes = {})
     {
-        type_of<T>()->m_methods.push_back(MethodInfo::Register<T, decltype(func), R, Args...>(name, func, attributes));
+        type_of<T>()->AddMethod(MethodInfo::Register<T, decltype(func), R, Args...>(name, func, attributes));
         return *this;
     }
 };
 
+// 通过 nameof 在编译期枚举 T 的全部枚举值，只能识别 nameof::customize::enum_range<T> 范围内的值
+template <typename T>
+struct StaticEnumTable
+{
+    static constexpr auto& values = nameof::detail::values_v<T>;
+
+    template <size_t... I>
+    static constexpr auto MakeInfos(std::index_sequence<I...>)
+    {
+        return std::array<EnumInfo, sizeof...(I)>{EnumInfo{static_cast<int64_t>(values[I]), std::string_view(nameof::detail::enum_name_v<T, values[I]>.data(), nameof::detail::enum_name_v<T, values[I]>.size())}...};
+    }
+
+    // values_v 按值升序且无重复
+    static constexpr auto infos = MakeInfos(std::make_index_sequence<values.size()>{});
+
+    static constexpr auto slots = []
+    {
+        std::array<uint32_t, GetHashSlotCount(infos.size())> slots{};
+        BuildEnumNameSlots(infos, slots);
+        return slots;
+    }();
+};
+
 template <typename T>
 struct TypeRegister<T, true>
 {
@@ -225,10 +248,10 @@ public:
     static TypeRegister<T> New(const std::map<size_t, std::any>& attributes = {})
     {
         Type* type = type_of<T>();
-        type->m_attributes = attributes;
+        type->SetAttributes(attributes);
 
         TypeRegister<T> reg;
-        type->m_constructors.push_back(ConstructorInfo::Register<T>(&ctor<T, const T&>));
+        type->AddConstructor(ConstructorInfo::Register<T>(&ctor<T, const T&>));
 
         return reg;
     }
@@ -236,25 +259,32 @@ public:
     static TypeRegister<T> New(const std::string& name, const std::map<size_t, std::any>& attributes = {})
     {
         Type* type = type_of<T>();
-        type->m_name = name;
-        type->m_attributes = attributes;
+        type->SetName(name);
+        type->SetAttributes(attributes);
 
         TypeRegister<T> reg;
-        type->m_constructors.push_back(ConstructorInfo::Register<T>(&ctor<T, const T&>));
+        type->AddConstructor(ConstructorInfo::Register<T>(&ctor<T, const T&>));
 
         return reg;
     }
 
     TypeRegister<T>& value(const std::string& name, T v)
     {
-        type_of<T>()->m_enumValues[name] = Box(v);
+        type_of<T>()->AddEnumValue(name, static_cast<int64_t>(v));
+        return *this;
+    }
+
+    // 使用编译期生成的枚举值表，替代逐个调用 value()
+    TypeRegister<T>& values()
+    {
+        type_of<T>()->SetEnumTable(StaticEnumTable<T>::infos, StaticEnumTable<T>::slots);
         return *this;
     }
 
     template <typename U>
     TypeRegister<T>& compare()
     {
-        type_of<T>()->m_objectComparers.push_back({type_of<U>(), &comparer<T, U>});
+        type_of<T>()->AddComparer({type_of<U>(), &comparer<T, U>});
         return *this;
     }
 };
@@ -262,22 +292,28 @@ public:
 template <typename T>
 inline Type* DefaultEnumRegister(Type* type)
 {
-    if (!type->m_constructors.empty())
-        return type;
-
     using UT = std::underlying_type<T>::type;
 
-    type->m_constructors.push_back(ConstructorInfo::Register(type, &ctor<T>));
-    type->m_constructors.push_back(ConstructorInfo::Register(type, &ctor<T, const T&>));
-    type->m_constructors.push_back(ConstructorInfo::Register(type, &ctor<T, UT>));
+    type->m_enumBox = [](int64_t value) -> ObjectPtr
+    {
+        return rtti::Box(static_cast<T>(value));
+    };
+    type->m_enumUnbox = [](const ObjectPtr& obj) -> int64_t
+    {
+        return static_cast<int64_t>(rtti::Unbox<T>(obj));
+    };
+
+    type->AddConstructor(ConstructorInfo::Register(type, &ctor<T>));
+    type->AddConstructor(ConstructorInfo::Register(type, &ctor<T, const T&>));
+    type->AddConstructor(ConstructorInfo::Register(type, &ctor<T, UT>));
 
-    type->m_typeConvertors.push_back({type_of<UT>(), [](const ObjectPtr& obj, [[maybe_unused]] Type* targetType, ObjectPtr& target) -> bool
-                                      {
-                                          target = rtti::Box(static_cast<UT>(rtti::Unbox<T>(obj)));
-                                          return true;
-                                      }});
+    type->AddConvertor({type_of<UT>(), [](const ObjectPtr& obj, [[maybe_unused]] Type* targetType, ObjectPtr& target) -> bool
+                        {
+                            target = rtti::Box(static_cast<UT>(rtti::Unbox<T>(obj)));
+                            return true;
+                        }});
 
-    type->m_objectComparers.push_back({type_of<T>(), &comparer<T, T>});
+    type->AddComparer({type_of<T>(), &comparer<T, T>});
 
     return type;
 }
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <thread>
 #define RTTI_ENABLE_LOG 1
 #include <RTTI.h>
 
@@ -43,13 +44,25 @@ struct TestStruct
         TE = (TestEnum)a;
     }
 
+    uintptr_t Address(const std::string& s) const
+    {
+        return reinterpret_cast<uintptr_t>(&s);
+    }
+
+    bool IsText(const rtti::ObjectPtr& text) const
+    {
+        return text != nullptr && text->GetType() == rtti::type_of<const char*>();
+    }
+
     static void RegisterRTTI()
     {
         rtti::TypeRegister<TestStruct>::New()
             .constructor<>()
             .convert<int>()
             .property("TE"s, &TestStruct::TE, {})
-            .method("Func"s, &TestStruct::Func);
+            .method("Func"s, &TestStruct::Func)
+            .method("Address"s, &TestStruct::Address)
+            .method("IsText"s, &TestStruct::IsText);
     }
 };
 
@@ -123,7 +136,7 @@ public:
             .constructor<int>()
             .constructor<int, float>()
             .convert<int>()
-            .property("A"s, &Test::A, {})
+            .property("A"s, &Test::A, {DisplayName("PropertyA")})
             .property("B"s, &Test::B, {})
             .property("C"s, &Test::C, {})
             .property("D"s, &Test::D, {})
@@ -316,6 +329,9 @@ void RegisterTypes()
         .value("Value1", TestEnum::Value1)
         .value("Value2", TestEnum::Value2);
 
+    rtti::TypeRegister<TestEnum2>::New()
+        .values();
+
     TestStruct::RegisterRTTI();
 
     TestBase::RegisterRTTI();
@@ -325,9 +341,133 @@ void RegisterTypes()
     Handle<Test>::RegisterRTTI();
 }
 
+struct RenamedStruct
+{
+};
+
+template <int N>
+struct PluginStruct
+{
+    int Value = N;
+
+    int GetValue() const { return Value; }
+};
+
+template <int N>
+void RegisterPlugin()
+{
+    rtti::TypeRegister<PluginStruct<N>>::New("PluginStruct"s + std::to_string(N))
+        .method("GetValue", &PluginStruct<N>::GetValue);
+}
+
+// 装箱对象在一个线程中创建，在另一个线程中释放
+void TestBoxPool()
+{
+    std::vector<rtti::ObjectPtr> boxes;
+    std::thread producer([&]
+                         {
+                             for (int i = 0; i < 10000; i++)
+                                 boxes.push_back(rtti::Box((double)i));
+                         });
+    producer.join();
+
+    // 生产线程已退出，其堆由之后的线程接管
+    std::thread consumer([&]
+                         {
+                             for (int i = 0; i < 10000; i++)
+                                 assert(rtti::Unbox<double>(boxes[i]) == (double)i);
+                             boxes.clear();
+                             for (int i = 0; i < 10000; i++)
+                                 boxes.push_back(rtti::Box((double)i));
+                         });
+    consumer.join();
+
+    for (int i = 0; i < 10000; i++)
+        assert(rtti::Unbox<double>(boxes[i]) == (double)i);
+    boxes.clear();
+}
+
+#if defined(RTTI_INTRUSIVE_PTR)
+// 引用计数在对象中，由原始指针构造的 Ptr 与原有的 Ptr 共享计数
+void TestIntrusivePtr()
+{
+    static_assert(sizeof(rtti::ObjectPtr) == sizeof(void*));
+
+    auto obj = rtti::MakePtr<Test>();
+    assert(obj->GetRefCount() == 1);
+    {
+        rtti::ObjectPtr other = RTTI_PTR_FROM_RAW(RTTI_RAW_FROM_PTR(obj));
+        assert(obj->GetRefCount() == 2 && other == obj);
+        auto base = rtti::cast<rtti::Ptr<TestBase>>(other);
+        assert(obj->GetRefCount() == 3 && base == obj);
+    }
+    assert(obj->GetRefCount() == 1);
+}
+#endif
+
+// 工作线程注册类型的同时，其他线程无锁查询
+void TestConcurrentRegistry()
+{
+    std::atomic<bool> done = false;
+    std::thread reader([&]
+                       {
+                           while (!done.load())
+                           {
+                               assert(rtti::Type::Find("Test") == rtti::type_of<Test>());
+                               assert(rtti::type_of<Test>()->GetMethod("Func1") != nullptr);
+                               assert(rtti::type_of<int>()->CanConvertTo<double>());
+                               size_t count = 0;
+                               rtti::Type::ForEach([&](rtti::Type* t) { count += t->GetName().empty() ? 0 : 1; });
+                               assert(count <= rtti::Type::GetTypeCount());
+                           }
+                       });
+
+    std::thread writers[] = {std::thread(RegisterPlugin<1>), std::thread(RegisterPlugin<2>), std::thread(RegisterPlugin<3>), std::thread(RegisterPlugin<4>)};
+    for (auto& writer : writers)
+        writer.join();
+
+    done = true;
+    reader.join();
+
+    assert(rtti::Type::Find("PluginStruct1") == rtti::type_of<PluginStruct<1>>());
+    assert(rtti::Type::Find("PluginStruct4") == rtti::type_of<PluginStruct<4>>());
+    assert(rtti::type_of<PluginStruct<3>>()->GetMethods().size() == 1);
+}
+
+// 每次注册构造函数都使转换规则缓存失效，随后的查询替换下旧的缓存
+template <size_t... N>
+void RegisterPlugins(std::index_sequence<N...>)
+{
+    ((rtti::TypeRegister<PluginStruct<100 + N>>::New("PluginStruct"s + std::to_string(100 + N)).template constructor<>(), (void)rtti::type_of<int>()->CanConvertTo<double>()), ...);
+}
+
+// 没有活跃读者时，转换规则等内部快照替换下来后很快释放，不随注册累积
+void TestEpochReclaim()
+{
+    auto epoch = rtti::GetGlobalEpoch().load();
+    RegisterPlugins(std::make_index_sequence<32>{});
+    assert(rtti::GetGlobalEpoch().load() - epoch >= 32 && rtti::GetEpochRetiredList().size() <= 2);
+}
+
 int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
 {
     RegisterTypes();
+    TestConcurrentRegistry();
+    TestEpochReclaim();
+    TestBoxPool();
+#if defined(RTTI_INTRUSIVE_PTR)
+    TestIntrusivePtr();
+#endif
+
+    // 改名后旧名称的字符串随旧快照回收，按旧名称查找不能再访问它
+    auto renamedType = rtti::type_of<RenamedStruct>();
+    assert(rtti::Type::Find("RenamedStruct") == renamedType);
+    rtti::TypeRegister<RenamedStruct>::New("RenamedStruct2");
+    rtti::ReclaimRetired();
+    assert(rtti::Type::Find("RenamedStruct") == nullptr && rtti::Type::Find("RenamedStruct2") == renamedType);
+
+    rtti::Type::Freeze();
+    assert(rtti::Type::IsFrozen());
 
     printf("%s - %d - %s\n", rtti::type_of<int*>()->GetName().c_str(), rtti::type_of<int*>()->IsPointer(), rtti::type_of<int*>()->GetUnderlyingType()->GetName().c_str());
 
@@ -351,14 +491,50 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
     assert(ht2 == ht.GetPtr());
 
     assert(rtti::type_of<TestEnum>()->GetAttribute<std::string>(DisplayNameAttr) == "TestEnumForDisplay"s);
+    assert(*rtti::type_of<TestEnum>()->FindAttribute<std::string>(DisplayNameAttr) == "TestEnumForDisplay"s);
+    assert(rtti::type_of<TestEnum>()->FindAttribute<int>(DisplayNameAttr) == nullptr && rtti::type_of<TestEnum2>()->FindAttribute<std::string>(DisplayNameAttr) == nullptr);
+    assert(&rtti::type_of<TestEnum>()->GetAttribute(DisplayNameAttr) == &rtti::type_of<TestEnum>()->GetAttributes().front().Value);
+
+    auto displayNameTargets = rtti::Type::GetAttributeTargets(DisplayNameAttr);
+    assert(displayNameTargets.size() == 2);
+    assert(displayNameTargets[0].Kind == rtti::AttributeTargetKind::Type && displayNameTargets[0].Target == rtti::type_of<TestEnum>());
+    assert(displayNameTargets[1].Kind == rtti::AttributeTargetKind::Property && displayNameTargets[1].Target == rtti::type_of<Test>()->GetProperty("A"));
+    assert(rtti::Type::GetAttributeTargets(HASH("handle")).size() == 2 && rtti::Type::GetAttributeTargets(HASH("NotExists")).empty());
+    assert(rtti::type_of<TestEnum>()->GetEnumInfos().size() == 2);
+    assert(rtti::type_of<TestEnum>()->GetEnumName(1) == "Value2");
+    assert(rtti::type_of<TestEnum>()->GetEnumName(2).empty());
+    assert(rtti::type_of<TestEnum>()->GetEnumName(rtti::Box(TestEnum::Value1)) == "Value1"s);
+    assert(rtti::Unbox<TestEnum>(rtti::type_of<TestEnum>()->GetEnumValue("Value2")) == TestEnum::Value2);
+    assert(rtti::type_of<TestEnum>()->GetEnumValue("Value3") == nullptr);
+    assert(rtti::type_of<TestEnum2>()->GetEnumInfos().size() == 2);
+    assert(rtti::type_of<TestEnum2>()->GetEnumName(1) == "Value2");
+    assert(rtti::type_of<TestEnum2>()->FindEnumInfo("Value1")->Value == 0);
 
     assert(rtti::type_of<int>() == rtti::Box(123)->GetRttiType());
+    // GetType() 与 GetRttiType() 一致，开启类型缓存时读取缓存的类型
+    assert(rtti::Box(123)->GetType() == rtti::type_of<int>() && rtti::MakePtr<Test>()->GetType() == rtti::type_of<Test>());
+#if defined(RTTI_BOX_CACHE)
+    assert(rtti::Box(123) == rtti::Box(123) && rtti::Box(true) == rtti::cast<rtti::ObjectPtr>(true) && rtti::Box(100000) != rtti::Box(100000));
+    assert(rtti::Box(TestEnum::Value2) == rtti::Box(TestEnum::Value2) && rtti::Box((TestEnum)5) != rtti::Box((TestEnum)5));
+    assert(static_cast<rtti::ObjectBox*>(RTTI_RAW_FROM_PTR(rtti::Box(7)))->IsReadOnly() && rtti::Unbox<const int&>(rtti::Box(7)) == 7);
+#else
+    assert(rtti::Box(123) != rtti::Box(123) && !static_cast<rtti::ObjectBox*>(RTTI_RAW_FROM_PTR(rtti::Box(7)))->IsReadOnly());
+#endif
 
     auto type = rtti::Type::Find("Test"s);
+    assert(type == rtti::type_of<Test>());
+    assert(rtti::Type::Find("TestStruct") == rtti::type_of<TestStruct>());
+    assert(rtti::Type::Find(std::string_view("ulong")) == rtti::type_of<unsigned long>());
+    assert(rtti::Type::Find("unsigned long") == nullptr);
+    assert(rtti::Type::Find("NotExists") == nullptr);
+    assert(rtti::Type::FromId(type->GetId()) == type && rtti::Type::FromId((rtti::TypeId)rtti::Type::GetTypeCount()) == nullptr);
+    assert(rtti::type_of<rtti::Object>()->GetId() < rtti::type_of<TestBase>()->GetId());
 
     auto obj = type->Create<Test>();
     auto obj1 = type->Create<Test>(123);
     auto obj2 = type->Create<Test>(123, 789.12f);
+    assert(type->Create<Test>(456, 1.5f) != nullptr);
+    assert(type->Create<Test>("str"s) == nullptr);
 
     assert(rtti::cast<void*>(obj) == RTTI_RAW_FROM_PTR(obj));
     assert(rtti::cast<Test>((TestBase*)RTTI_RAW_FROM_PTR(obj)) == RTTI_RAW_FROM_PTR(obj));
@@ -368,6 +544,8 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
     rtti::Type::Convert(obj, rtti::type_of<int>(), ttt);
 
     assert(rtti::cast<int>(ttt) == 128);
+    assert(!rtti::type_of<int>()->CanConvertTo<std::string>());
+    assert(rtti::cast<TestEnum>((int8_t)1) == TestEnum::Value2);
     assert(rtti::cast<uint16_t>(ttt) == 128);
     assert(abs(rtti::cast<double>(ttt) - 128.0) <= 0.0001);
     auto comparable_enum_enum = rtti::is_comparable<TestEnum, TestEnum>();
@@ -381,8 +559,15 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
     assert(rtti::compare(ttt, 128.0f) == rtti::CompareResult::Equals);
     assert(rtti::compare(0u, ttt) == rtti::CompareResult::NotEquals);
     assert(rtti::compare(ttt, std::string("xxx")) == rtti::CompareResult::Failed);
+    assert(rtti::Type::Compare(ttt, nullptr) == rtti::CompareResult::Failed);
+    assert(rtti::Type::Compare(nullptr, nullptr) == rtti::CompareResult::Equals);
     assert(ttt->GetHashCode() == std::hash<int>()(128));
 
+    assert(type->IsSubClassOf<TestBase>() && type->IsSubClassOf<rtti::Object>());
+    assert(!type->IsSubClassOf<Test>() && !rtti::type_of<TestBase>()->IsSubClassOf<Test>());
+    assert(!type->IsSubClassOf<rtti::ObjectBox>() && rtti::type_of<int>()->IsSubClassOf<rtti::ObjectBox>());
+    assert(type->GetDepth() == 2 && rtti::type_of<rtti::Object>()->GetDepth() == 0);
+
     assert(rtti::cast<TestBase>(obj) != nullptr);
     assert(rtti::cast<Test>(rtti::cast<TestBase>(obj)) != nullptr);
 
@@ -429,6 +614,15 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
         printf("\n");
     }
 
+    assert(type->GetMethod("Func1")->OwnerType() == rtti::type_of<TestBase>());
+    assert(type->GetMethod("Func5", {rtti::type_of<int>()})->OwnerType() == type);
+    assert(type->GetMethod("Func5", {rtti::type_of<float>()}) == nullptr);
+    assert(type->GetMethod("NotExists") == nullptr);
+    assert(type->GetProperty("TestBaseA")->OwnerType() == rtti::type_of<TestBase>());
+    assert(type->GetProperty("A")->OwnerType() == type);
+    assert(type->GetMethods().size() == 12 && type->GetMethods().back()->OwnerType() == rtti::type_of<TestBase>());
+    assert(type->GetProperties().size() == 9 && type->GetProperties().data() == type->GetProperties().data());
+
     printf("\n");
     printf("\033[31m [Test] \033[0m\n");
 
@@ -448,6 +642,107 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
 
     assert(testStruct.TE == (TestEnum)4);
 
+    // 参数直接引用调用方的存储，类型不一致时转换
+    int arg = 5;
+    const rtti::ArgRef refs[] = {arg};
+    rtti::type_of<TestStruct>()->GetMethod("Func"s)->Invoke(rtti::Box(&testStruct), refs);
+    assert(testStruct.TE == (TestEnum)5);
+    rtti::type_of<TestStruct>()->GetMethod("Func"s)->Invoke(rtti::Box(&testStruct), TestEnum::Value2);
+    assert(testStruct.TE == TestEnum::Value2);
+    rtti::type_of<TestStruct>()->GetMethod("Func"s)->Invoke(rtti::Box(&testStruct), rtti::Box(6));
+    assert(testStruct.TE == (TestEnum)6);
+    // 字符串字面量与按值传参一样退化为 const char*
+    assert(rtti::Unbox<bool>(rtti::type_of<TestStruct>()->GetMethod("IsText"s)->Invoke(rtti::Box(&testStruct), "text")));
+    assert(rtti::Unbox<int>(type->GetMethod("Func3"s)->Invoke(obj)) == 34);
+    type->GetMethod("Func7"s, {rtti::type_of<TestBase>()})->Invoke(obj, obj);
+    assert(type->GetConstructors()[2]->Invoke(7, 1.5f) != nullptr);
+
+    // ObjectPtr 参数可以放在栈上的数组中
+    const rtti::ObjectPtr objects[] = {rtti::Box(8)};
+    rtti::type_of<TestStruct>()->GetMethod("Func"s)->Invoke(rtti::Box(&testStruct), objects);
+    assert(testStruct.TE == (TestEnum)8);
+    const rtti::ObjectPtr ctorArgs[] = {rtti::Box(1), rtti::Box(2.5f)};
+    assert(type->CreateInstance(ctorArgs) != nullptr && type->CreateInstance({}) != nullptr);
+
+    // 同一方法批量调用多个目标，类型不符的目标跳过
+    const rtti::ObjectPtr targets[] = {obj, rtti::MakePtr<Test>(), rtti::Box(testStruct), obj};
+    rtti::ObjectPtr results[4];
+    assert(type->GetMethod("Func3"s)->InvokeBatch(targets, {}, results) == 3);
+    assert(rtti::Unbox<int>(results[0]) == 34 && rtti::Unbox<int>(results[3]) == 34 && results[2] == nullptr);
+    TestStruct batchStructs[2];
+    const rtti::ObjectPtr structTargets[] = {rtti::Box(&batchStructs[0]), rtti::Box(&batchStructs[1])};
+    assert(rtti::type_of<TestStruct>()->GetMethod("Func"s)->InvokeBatch(structTargets, 9) == 2);
+    assert(batchStructs[0].TE == (TestEnum)9 && batchStructs[1].TE == (TestEnum)9);
+
+    // 签名一致时直接调用注册的成员函数
+    auto func3 = type->GetMethod("Func3"s)->TryGetInvoker<int(Test&)>();
+    assert(func3 && func3(*rtti::cast<rtti::Ptr<Test>>(obj)) == 34);
+    assert(!type->GetMethod("Func3"s)->TryGetInvoker<int(Test&, int)>());
+    assert(!type->GetMethod("Func3"s)->TryGetInvoker<float(Test&)>());
+    auto structFunc = rtti::type_of<TestStruct>()->GetMethod("Func"s)->TryGetInvoker<void(TestStruct&, int)>();
+    structFunc(testStruct, 7);
+    assert(testStruct.TE == (TestEnum)7);
+
+    // 右值移动到装箱对象中，const T& 参数直接引用装箱对象中的值
+    std::string payload(64, 'x');
+    auto payloadData = payload.data();
+    auto payloadBox = rtti::Box(std::move(payload));
+    assert(rtti::Unbox<const std::string&>(payloadBox).data() == payloadData);
+    // 显式指定类型时左值参数按值复制
+    int boxedInt = 42;
+    const std::string boxedText = "text";
+    assert(rtti::Unbox<int>(rtti::Box<int>(boxedInt)) == 42 && rtti::Unbox<std::string>(rtti::Box<std::string>(boxedText)) == boxedText);
+    assert(rtti::Box(boxedText)->GetRttiType() == rtti::type_of<std::string>());
+    auto address = rtti::type_of<TestStruct>()->GetMethod("Address"s)->Invoke(rtti::Box(&testStruct), {payloadBox});
+    assert(rtti::Unbox<uintptr_t>(address) == reinterpret_cast<uintptr_t>(&rtti::Unbox<const std::string&>(payloadBox)));
+
+    // 冻结后继续注册须先显式解除冻结，完成后重新冻结
+    assert(rtti::Type::IsFrozen() && rtti::Type::Find("PluginStruct5") == nullptr);
+    rtti::Type::Unfreeze();
+    assert(!rtti::Type::IsFrozen());
+    RegisterPlugin<5>();
+    rtti::Type::Freeze();
+    assert(rtti::Type::Find("PluginStruct5")->GetMethod("GetValue") != nullptr);
+    assert(type->GetMethod("Func1")->OwnerType() == rtti::type_of<TestBase>());
+
+    // 模块的元数据分配在独立的 arena 中，卸载时一次释放
+    {
+        rtti::Arena module;
+        {
+            rtti::ArenaScope scope(module);
+            RegisterPlugin<6>();
+            // 模块给已有类型注册的转换同样属于该 arena
+            rtti::TypeRegister<TestStruct>::New().convert<double>();
+        }
+        assert(rtti::type_of<TestStruct>()->CanConvertTo<double>());
+
+        auto pluginType = rtti::Type::Find("PluginStruct6");
+        assert(pluginType != nullptr && module.Owns(pluginType) && module.Owns(pluginType->GetMethod("GetValue")));
+        auto pluginId = pluginType->GetId();
+
+        rtti::Type::Release(module);
+        assert(rtti::Type::Find("PluginStruct6") == nullptr && rtti::Type::FromId(pluginId) == nullptr);
+        assert(rtti::GetRetiredList().load() == nullptr);
+        assert(rtti::Type::Find("PluginStruct5")->GetMethod("GetValue") != nullptr);
+        assert(!rtti::type_of<TestStruct>()->CanConvertTo<double>() && rtti::type_of<TestStruct>()->CanConvertTo<int>());
+
+        // 对齐要求超过 new[] 保证的对齐时按绝对地址补齐
+        rtti::Arena aligned(64);
+        for (size_t alignment : {8, 32, 64, 128})
+        {
+            auto p = aligned.Allocate(3, alignment);
+            assert(reinterpret_cast<uintptr_t>(p) % alignment == 0 && aligned.Owns(p));
+        }
+
+        // 释放后编号表中留有空位，冻结时跳过
+        rtti::Type::Freeze();
+        assert(rtti::Type::IsFrozen() && rtti::Type::Find("PluginStruct6") == nullptr);
+        assert(rtti::Type::Find("PluginStruct5")->GetMethod("GetValue") != nullptr);
+    }
+
+    rtti::Shutdown();
+    assert(rtti::Type::Find("Test") == nullptr);
+
     printf("\n");
 
     return 0;